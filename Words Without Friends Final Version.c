@@ -7,6 +7,40 @@
  *              It allows users to play a word-guessing game via the web browser, with dynamic updates of the game state.
  *              To play, navigate to the URL: localhost:8000/filename.c (replace 'filename.c' with the appropriate file name).
  *              Use the cheat code "110" in the game input to reveal all words.
+ *              Bulk clients can submit many guesses at once via localhost:8000/batch?move=a&move=b (or POST the list).
+ *              Hints: localhost:8000/hint?length=5&prefix=TR counts the matching words still hidden, &reveal=1
+ *              uncovers one of them (looked up in the puzzle's sorted hint index).
+ *              Every correct guess scores its player (player=name on the guess, else the client address) one
+ *              point per letter; words revealed by hints or the cheat code score nothing. localhost:8000/leaderboard
+ *              serves the top players overall and on the current puzzle and the fastest completions, kept off
+ *              the request path by a score keeper thread (scoreboard.c).
+ *              Other services check which words a rack of letters can form at localhost:8000/validate?rack=letters
+ *              with word=a&word=b (or POST the list); without words every dictionary word for the rack is returned.
+ *              Live updates (words found, new puzzles) are pushed as Server-Sent Events at localhost:8000/events.
+ *              Counters and per-stage latency histograms are served in Prometheus format at localhost:8000/metrics.
+ *              Start with -s <seed> to make the puzzle sequence reproducible (used by bench/loadGenerator).
+ *              The dictionary is compiled in (WWF_EMBED_DICTIONARY); -d <file> loads a custom word list instead.
+ *              SIGHUP reloads the word list file in the background; games in progress keep their words.
+ *              -n <min:max> limits new boards to between min and max words (looked up in the puzzle index).
+ *              -l <n> opens n listeners on the port with SO_REUSEPORT, each with its own acceptor thread
+ *              and its own 8 workers, so the kernel spreads connections over cores; -b <n> sets the backlog.
+ *              Admission: connections wait in a bounded per-listener queue (-q) for a free worker and are
+ *              answered 503 with Retry-After when it is full, when they waited too long, or when their
+ *              address already holds -i connections. Clients get -t seconds to send and to take each response.
+ *              Those deadlines sit in a timer wheel per listener (timerWheel.c) that its acceptor thread expires
+ *              in batches; an expired connection is shut down, which wakes the worker blocked on it.
+ *              The board page is rendered once per game state version and, for clients that send
+ *              Accept-Encoding, compressed once per encoding (gzip, deflate); every other request reuses it.
+ *              Pages carry an ETag of puzzle id and game state version; a matching If-None-Match is
+ *              answered 304 Not Modified without rendering anything.
+ *              -p <file> keeps a binary snapshot of the game (snapshot.c), rewritten every -P seconds
+ *              when the state changed and on SIGTERM/SIGINT; a restart restores it instead of dealing a new board.
+ *              -m <name> plays one game across every server process started with the same name: the board,
+ *              its found words and the state version live in POSIX shared memory (sharedGame.c) and each
+ *              process follows them; run several on the port and the kernel spreads clients over them.
+ *              Scores and /leaderboard stay per process: each one ranks the guesses it served, though
+ *              every shared board's completion is credited by one process only.
+ *              Logs are written as key=value lines by a background thread; set WWF_LOG_LEVEL=debug|info|warn|error|off.
  *              The server retrieves requested files or sends an appropriate error message if the file is not found.
  *              Proper thread management ensures resource cleanup and efficient handling of multiple clients.
  */
@@ -18,162 +52,878 @@
 #include <netinet/in.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <netdb.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <ctype.h>
 #include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <stdarg.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <limits.h>
+#include "wordEngine.h"
+#include "logger.h"
+#include "metrics.h"
+#include "timerWheel.h"
+#include "snapshot.h"
+#include "sharedGame.h"
+#include "scoreboard.h"
+#include <zlib.h>
+
+//Worker thread slots of every listener
+#define WORKERS_PER_LISTENER 8
+//Upper bound for -l
+#define MAX_LISTENERS 64
+//Buckets of the per-address connection table
+#define CLIENT_TABLE_SIZE 1024
+//Connection deadline kinds: waiting in the queue, for the request head, for a POST body, on the response
+#define TIMEOUT_QUEUE 0
+#define TIMEOUT_HEADER 1
+#define TIMEOUT_BODY 2
+#define TIMEOUT_WRITE 3
+#define TIMEOUT_KINDS 4
+//Response body encodings, negotiated from Accept-Encoding
+#define ENCODING_IDENTITY 0
+#define ENCODING_GZIP 1
+#define ENCODING_DEFLATE 2
+#define ENCODING_COUNT 3
 
 //structure 
+//Connection deadline in the listener's timer wheel; all fields are guarded by the listener's lock
+struct connectionTimer{
+	struct wheelTimer timer;
+	int socket;
+	int kind;
+	int fired;
+};
 struct myThread{
 	pthread_t id;
 	int isDone;
+	struct listener *owner;
+	struct connectionTimer deadline;
+	//Client address of the connection in service (network byte order)
+	uint32_t address;
+};
+//Accepted connection waiting in a listener's queue for a worker
+struct pendingConnection{
+	int socket;
+	uint32_t address;
+	unsigned long long acceptedAt;
+	struct connectionTimer deadline;
+};
+//Listening socket with the acceptor thread that owns it and that thread's workers
+struct listener{
+	int index;
+	int socket;
+	pthread_t acceptorId;
+	struct myThread thread[WORKERS_PER_LISTENER];
+	atomic_ulong connections;
+	//Ring buffer of PENDING_QUEUE_SIZE admitted connections; it, the slots' isDone and the wheel are guarded by lock
+	struct pendingConnection *pending;
+	int pendingHead;
+	int pendingCount;
+	pthread_mutex_t lock;
+	//Deadlines of the queued connections and of the workers' connections, expired by the acceptor
+	struct timerWheel wheel;
+	//Written by armTimeout to wake an acceptor that sleeps without a poll timeout (isSleeping)
+	int wakePipe[2];
+	int isSleeping;
+};
+//Rendered page of one game state version, with its compressed variants (filled on first use under lock)
+struct renderedPage{
+	unsigned long puzzleId;
+	unsigned long version;
+	char *body[ENCODING_COUNT];
+	size_t length[ENCODING_COUNT];
+	int compressFailed[ENCODING_COUNT];
+	pthread_mutex_t lock;
+	atomic_int refCount;
 };
-//word List Node Structure 
-struct wordListNode{
-	char str[30];
-	struct wordListNode *next;
+//Client address with its queued and in-service connections, chained in clientTable
+struct clientAddress{
+	uint32_t address;
+	int connections;
+	struct clientAddress *next;
 };
-//game List Node Structure
-struct gameListNode{
-	char str[30];
-	int isFound;
-	struct gameListNode *next;
+//Server-Sent Event Structure, serialized once and shared by every subscriber
+struct sseEvent{
+	char *data;
+	size_t length;
+	struct sseEvent *next;
 };
 
 //function prototype 
-int isThreadAvailable();
-int serverSocketCreate();
-int initialization();
-int compareCounts(int *choiceCount, int *userInputCount);
-int *getLetterDistribution(char *strInput);
-int isDone();
-char *displayGameList(struct gameListNode *root);
-char *acceptInput(char *input);
-char *displayWord(char *masterWordStr);
-struct wordListNode *createWordList(char *word);
-struct gameListNode *createGameList(char *word);
-struct wordListNode *getRandomWord(struct wordListNode* root, int wordCount);
-struct gameListNode *findWords(char *masterWord);
-void capitalizedWordInGameList(struct gameListNode *root);
-void addWordNode(char *word, struct wordListNode *root);
+int isThreadAvailable(struct listener *owner);
+int serverSocketCreate(int reusePort);
+void *acceptConnections(void *value);
+int admitConnection(struct listener *owner, int clientSocket, uint32_t address);
+void *connectionWorker(void *value);
+void rejectConnection(int clientSocket);
+int admitClient(uint32_t address);
+void releaseClient(uint32_t address);
+void expireConnection(struct wheelTimer *timer, void *value);
+void armTimeout(int kind);
+int cancelTimeout();
+void closeConnection(int clientSocket);
 void *findFile (void *value);
-void addGameListNode(char *word, struct gameListNode *root);
-void gameLoop(int wordPositionInDictionary);
-void displayList(struct wordListNode *root);
 void tearDown();
-void cheat();
-void setAllWordsToNotFound();
-void cleanupWordListNode();
-void cleanupGameListNode();
+void *sseBroadcaster(void *value);
+int sseSubscribe(int clientSocket);
+void publishEvent(const char *eventName, const char *data);
+void publishWordFound(char *word);
+void publishNewPuzzle(struct puzzle *puzzle);
+struct puzzle *acquirePuzzle();
+void wordsFound(struct puzzle *puzzle, struct gameListNode **words, int count, int isGuessed);
+void tryRollover();
+void syncSharedGame();
+void *sharedGameFollower(void *value);
+void identifyPlayer(const char *query);
+void scoreWords(struct puzzle *puzzle, struct gameListNode **words, int count, int isCompleted);
+void *scoreKeeper(void *value);
+void handleLeaderboard(int clientSocket, int encoding);
+void *puzzleBuilder(void *value);
+void *dictionaryReloader(void *value);
+void *snapshotWriter(void *value);
+int writeGameSnapshot();
+void finishRequest(const char *path, int status, unsigned long long start);
+char *renderMetrics(size_t *length);
+void handleBatch(struct puzzle *puzzle, int clientSocket, char *query, char *body, size_t bodyReceived, long contentLength);
+void handleValidate(int clientSocket, char *query, char *body, size_t bodyReceived, long contentLength);
+void handleHint(struct puzzle *puzzle, int clientSocket, char *query);
+char *readBody(int clientSocket, char *body, size_t bodyReceived, long contentLength);
+int collectGuesses(char *list, const char *key, char **guesses, int guessCount, int maxGuesses);
+long getContentLength(char *request);
+int acceptedEncoding(char *request);
+void entityTag(char *tag, size_t size, unsigned long puzzleId, unsigned long version, int encoding);
+int isNotModified(char *request, const char *tag);
+struct renderedPage *renderPage(struct puzzle *puzzle, unsigned long version);
+struct renderedPage *acquirePage(struct puzzle *puzzle);
+void releasePage(struct renderedPage *page);
+int pageBody(struct renderedPage *page, int encoding, const char **body, size_t *length);
+char *compressBody(const char *data, size_t length, int encoding, size_t *compressedLength);
 
 //Global variable 
-int BUFFER_SIZE = 1024;
-int BACKLOG = 8;
-struct myThread thread[8];
+int BACKLOG = 128;
 const char *PORT_NUMBER = "8000";
+//Listeners opened on PORT_NUMBER (-l), listener 0 is served by the main thread
+int LISTENER_COUNT = 1;
+struct listener listener[MAX_LISTENERS];
 char PATH[100];
-char *serverFullMsg = "Sorry, Web Server is Full!";
-char *wordBuffer = NULL;
-char *masterWordHolder = NULL;
+char *serverFullMsg = "HTTP/1.1 503 Service Unavailable\r\nRetry-After: 1\r\nContent-Length: 26\r\n"
+	"Connection: close\r\n\r\nSorry, Web Server is Full!";
+//Connections each listener queues while all of its workers are busy (-q)
+int PENDING_QUEUE_SIZE = 64;
+//Milliseconds a connection may wait in the queue before it is turned away
+int QUEUE_DEADLINE_MS = 1000;
+//Seconds a client gets to send its request and to take each part of the response (-t)
+int CLIENT_TIMEOUT = 5;
+//Connections one client address may have queued or in service at once (-i)
+int MAX_CLIENT_CONNECTIONS = 32;
+//Connections per client address, guarded by clientTableLock
+struct clientAddress *clientTable[CLIENT_TABLE_SIZE];
+pthread_mutex_t clientTableLock = PTHREAD_MUTEX_INITIALIZER;
+//Worker slot of the calling thread, whose deadline armTimeout and cancelTimeout manage
+_Thread_local struct myThread *workerSlot = NULL;
+//Player the words found by the calling thread's request are credited to, set by identifyPlayer
+_Thread_local char requestPlayer[MAX_PLAYER_NAME];
 char fileName[40];
-//Create Root for Word List Node
-struct wordListNode *wordRoot = NULL;
-//Create Root for Game List Node
-struct gameListNode *gameRoot = NULL;
-//Pointer points to Master Word
-struct wordListNode *masterWord = NULL;
-//Prevent Program get into infinte loop
-int findBugHelper = 0;
-
+//Puzzle being played, and the next one prepared in the background (both guarded by puzzleLock)
+struct puzzle *currentPuzzle = NULL;
+struct puzzle *nextPuzzle = NULL;
+pthread_mutex_t puzzleLock = PTHREAD_MUTEX_INITIALIZER;
+//Signalled when the prepared puzzle has been used up and a new one must be built
+pthread_cond_t puzzleBuilderCond = PTHREAD_COND_INITIALIZER;
+//Bumped every time the shared game state changes (word found, new puzzle)
+atomic_ulong gameStateVersion = 0;
+//Page of the newest game state version rendered so far, guarded by pageLock (holds one reference)
+struct renderedPage *cachedPage = NULL;
+pthread_mutex_t pageLock = PTHREAD_MUTEX_INITIALIZER;
+const char *encodingName[ENCODING_COUNT] = {"identity", "gzip", "deflate"};
+//Upper bounds for one batched guess request (POST body size and number of guesses)
+int MAX_BATCH_BODY = 65536;
+int MAX_BATCH_GUESSES = 4096;
+//Upper bounds for one validation request (POST body size and number of candidate words)
+int MAX_VALIDATE_BODY = 1048576;
+int MAX_VALIDATE_WORDS = 131072;
+//Request ids handed out to log records
+atomic_ulong requestCounter = 0;
+//Whole-request latency and time spent waiting for a worker, served at /metrics
+struct latencyHistogram requestHistogram;
+struct latencyHistogram queueWaitHistogram;
+//Counters served at /metrics
+atomic_ulong connectionsTotal = 0;
+atomic_ulong rejectedTotal = 0;
+atomic_ulong clientLimitedTotal = 0;
+atomic_ulong timeoutTotal[TIMEOUT_KINDS];
+const char *timeoutName[TIMEOUT_KINDS] = {"queue", "header", "body", "write"};
+atomic_ulong notFoundTotal = 0;
+atomic_ulong badRequestTotal = 0;
+atomic_ulong rolloverTotal = 0;
+atomic_ulong workerBusyNanoseconds = 0;
+atomic_ulong dictionaryReloadTotal = 0;
+atomic_ulong dictionaryReloadFailedTotal = 0;
+atomic_ulong pageRenderTotal = 0;
+atomic_ulong pageCacheHitTotal = 0;
+atomic_ulong notModifiedTotal = 0;
+atomic_ulong hintTotal = 0;
+atomic_ulong hintRevealTotal = 0;
+atomic_ulong wordsCheckedTotal = 0;
+atomic_ulong validateNanoseconds = 0;
+atomic_ulong pageCompressTotal[ENCODING_COUNT];
+atomic_ulong pageBytesTotal[ENCODING_COUNT];
+//Signals handled by dictionaryReloader (SIGHUP)
+sigset_t reloadSignals;
+//Snapshot file of the game state (-p), NULL keeps none
+const char *snapshotPath = NULL;
+//Seconds between snapshots (-P), a snapshot is only written when the state changed
+int SNAPSHOT_INTERVAL = 5;
+//Signals that stop the server after a last snapshot, handled by snapshotWriter (SIGTERM, SIGINT)
+sigset_t shutdownSignals;
+//Start time of this process, part of every ETag: state versions start over (or resume from a snapshot) on restart
+unsigned long serverEpoch = 0;
+atomic_ulong snapshotTotal = 0;
+atomic_ulong snapshotFailedTotal = 0;
+//Shared memory game (-m) followed by this process, NULL when it plays alone
+const char *sharedGameName = NULL;
+struct sharedGame *sharedGame = NULL;
+//Milliseconds between checks of the shared game by sharedGameFollower
+int SHARED_SYNC_INTERVAL_MS = 10;
+//Held while the shared game state is applied to this process' copy
+pthread_mutex_t sharedSyncLock = PTHREAD_MUTEX_INITIALIZER;
+atomic_ulong sharedSyncTotal = 0;
+//Milliseconds the score keeper sleeps when no score event is queued
+int SCORE_INTERVAL_MS = 10;
+//Leaderboard JSON rendered by the score keeper after each batch of events, guarded by leaderboardLock (holds one reference)
+struct renderedPage *cachedLeaderboard = NULL;
+pthread_mutex_t leaderboardLock = PTHREAD_MUTEX_INITIALIZER;
+//Seconds between keepalive comments sent to idle SSE subscribers
+int SSE_KEEPALIVE = 15;
+//Sockets subscribed to /events, guarded by sseSubscriberLock
+int *sseSubscriber = NULL;
+int sseSubscriberCount = 0;
+int sseSubscriberCapacity = 0;
+pthread_mutex_t sseSubscriberLock = PTHREAD_MUTEX_INITIALIZER;
+//Pending events waiting for the broadcaster, guarded by sseQueueLock
+struct sseEvent *sseQueueHead = NULL;
+struct sseEvent *sseQueueTail = NULL;
+pthread_mutex_t sseQueueLock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t sseQueueCond = PTHREAD_COND_INITIALIZER;
 //main
 int main (int argc, char **argv){
 	//local variable 
-	int serverSocket, clientSocket;
-	struct sockaddr clientSocketAddress;
-	socklen_t clientSocketAddressSize = sizeof(clientSocketAddress);
-
-	//set all thread's status to available
-	for (int i = 0; i < 8; i++){
-		thread[i].isDone = 1;
+	pthread_t sseThreadId, builderThreadId, reloaderThreadId, snapshotThreadId, followerThreadId, scoreThreadId;
+	int option, isSeeded = 0, isRestored = 0;
+	unsigned int seed = 0;
+	struct gameSnapshot snapshot;
+	struct puzzle *adopted;
+	unsigned long sharedVersion;
+	unsigned long long restoreStart;
+
+	//optional flags: -s <seed> pins the puzzle sequence (load tests, benchmarks),
+	//-d <file> plays with a custom word list instead of the built-in dictionary,
+	//-n <min:max> only deals boards with between min and max words,
+	//-l <n> accepts on n SO_REUSEPORT listeners, -b <n> is the listen backlog,
+	//-q <n> connections queue per listener, -i <n> connections per client address,
+	//-t <seconds> is the client receive/send timeout,
+	//-p <file> snapshots the game state every -P <seconds> and restores it on start,
+	//-m <name> shares the game with the other processes started with that name
+	while ((option = getopt(argc, argv, "s:d:n:l:b:q:i:t:p:P:m:")) != -1){
+		if (option == 's'){
+			seed = (unsigned int)strtoul(optarg, NULL, 10);
+			isSeeded = 1;
+		}
+		else if (option == 'd'){
+			dictionaryPath = optarg;
+		}
+		else if (option == 'n'){
+			if (sscanf(optarg, "%d:%d", &puzzleMinSolutions, &puzzleMaxSolutions) != 2 || puzzleMinSolutions > puzzleMaxSolutions){
+				fprintf(stderr, "-n expects min:max words on the board\n");
+				return 1;
+			}
+		}
+		else if (option == 'l'){
+			LISTENER_COUNT = atoi(optarg);
+			if (LISTENER_COUNT < 1 || LISTENER_COUNT > MAX_LISTENERS){
+				fprintf(stderr, "-l expects between 1 and %d listeners\n", MAX_LISTENERS);
+				return 1;
+			}
+		}
+		else if (option == 'b'){
+			BACKLOG = atoi(optarg);
+			if (BACKLOG < 1){
+				fprintf(stderr, "-b expects a positive backlog\n");
+				return 1;
+			}
+		}
+		else if (option == 'p'){
+			snapshotPath = optarg;
+		}
+		else if (option == 'm'){
+			sharedGameName = optarg;
+		}
+		else if (option == 'q' || option == 'i' || option == 't' || option == 'P'){
+			int *setting = option == 'q' ? &PENDING_QUEUE_SIZE : option == 'i' ? &MAX_CLIENT_CONNECTIONS :
+				option == 't' ? &CLIENT_TIMEOUT : &SNAPSHOT_INTERVAL;
+			*setting = atoi(optarg);
+			if (*setting < 1){
+				fprintf(stderr, "-%c expects a positive number\n", option);
+				return 1;
+			}
+		}
+		else{
+			fprintf(stderr, "Usage: %s [-s seed] [-d dictionary] [-n min:max] [-l listeners] [-b backlog]"
+				" [-q queue] [-i perClient] [-t timeout] [-p snapshot] [-P seconds] [-m shared] <path>\n", argv[0]);
+			return 1;
+		}
 	}
 	//check if Path exist as parameter 
-	if (argc < 2){
+	if (optind >= argc){
 		//usage message 
-		fprintf(stderr, "Usage: %s <path>\n", argv[0]);
+		fprintf(stderr, "Usage: %s [-s seed] [-d dictionary] [-n min:max] [-l listeners] [-b backlog]"
+			" [-q queue] [-i perClient] [-t timeout] [-p snapshot] [-P seconds] [-m shared] <path>\n", argv[0]);
 		return 1;
 	}
 	//assign directory's path to PATH
-	strcpy(PATH, argv[1]);
+	strcpy(PATH, argv[optind]);
+	//a subscriber that hangs up must not kill the server with SIGPIPE
+	signal(SIGPIPE, SIG_IGN);
+	//SIGHUP is only ever taken by the reloader thread, block it before any thread starts
+	sigemptyset(&reloadSignals);
+	sigaddset(&reloadSignals, SIGHUP);
+	pthread_sigmask(SIG_BLOCK, &reloadSignals, NULL);
+	//with snapshots, SIGTERM and SIGINT are taken by the snapshot writer so the last moves are saved
+	if (snapshotPath != NULL){
+		sigemptyset(&shutdownSignals);
+		sigaddset(&shutdownSignals, SIGTERM);
+		sigaddset(&shutdownSignals, SIGINT);
+		pthread_sigmask(SIG_BLOCK, &shutdownSignals, NULL);
+	}
+	serverEpoch = (unsigned long)time(NULL);
+	//console output goes through the background log writer from here on
+	initLogging();
+	//found words bump the state version, reach subscribers, score and trigger rollover
+	wordsFoundHook = wordsFound;
+	initScoreboard();
 	
 	//Initialize the WordGuess Game
 	int wordPositionInDictionary = initialization();
-	//get the master word from dictionary randomly
-	masterWord = getRandomWord(wordRoot, wordPositionInDictionary);
-	//find all possible word that can formed by uses the letters of master word
-	findWords(masterWord->str);
-	// Set the 'found' status of all words in Game List to 'not found' in preparation for the game
-	setAllWordsToNotFound();
-
-	//Server socket create, Server Setup
-	serverSocket = serverSocketCreate();
-	//keep receiving client connect request, and assign a new thread to each requestor 
+	if (wordPositionInDictionary == 0){
+		fprintf(stderr, "Could not load the dictionary %s\n", dictionaryPath != NULL ? dictionaryPath : "2of12.txt");
+		return 1;
+	}
+	if (isSeeded == 1){
+		seedRandomWord(seed);
+	}
+	//resume the game the snapshot holds, or build the first puzzle;
+	//the builder thread keeps the next one ready from now on
+	restoreStart = nowNanoseconds();
+	if (snapshotPath != NULL && loadSnapshot(snapshotPath, &snapshot) == 0){
+		currentPuzzle = snapshot.puzzle[0];
+		nextPuzzle = snapshot.puzzleCount > 1 ? snapshot.puzzle[1] : NULL;
+		atomic_store(&gameStateVersion, snapshot.stateVersion);
+		isRestored = 1;
+		LOG(LOG_INFO, "event=snapshot_restored path=%s puzzle=%lu found=%d words=%d version=%lu duration_us=%llu",
+			snapshotPath, currentPuzzle->id, atomic_load(&currentPuzzle->foundCount), currentPuzzle->wordCount,
+			snapshot.stateVersion, (nowNanoseconds() - restoreStart) / 1000);
+	}
+	else{
+		currentPuzzle = buildPuzzle();
+		if (currentPuzzle == NULL){
+			fprintf(stderr, "Could not build a puzzle from the dictionary\n");
+			return 1;
+		}
+	}
+	//with -m the first process deals its board to the segment, the others take up the one there
+	if (sharedGameName != NULL){
+		sharedGame = attachSharedGame(sharedGameName, serverEpoch);
+		if (sharedGame == NULL){
+			fprintf(stderr, "Could not attach the shared game %s\n", sharedGameName);
+			return 1;
+		}
+		serverEpoch = sharedGame->epoch;
+		sharedVersion = atomic_load(&sharedGame->stateVersion);
+		if (dealSharedPuzzle(sharedGame, currentPuzzle, 0) != 1 && (adopted = adoptSharedPuzzle(sharedGame)) != NULL){
+			releasePuzzle(currentPuzzle);
+			currentPuzzle = adopted;
+		}
+		atomic_store(&gameStateVersion, sharedVersion);
+		LOG(LOG_INFO, "event=shared_game_joined name=%s puzzle=%lu found=%d words=%d", sharedGameName,
+			currentPuzzle->id, atomic_load(&currentPuzzle->foundCount), currentPuzzle->wordCount);
+	}
+	currentPuzzle->startedAt = nowNanoseconds();
+	pthread_create(&builderThreadId, NULL, puzzleBuilder, NULL);
+	pthread_detach(builderThreadId);
+
+	//start the thread that swaps in a new word list on SIGHUP
+	pthread_create(&reloaderThreadId, NULL, dictionaryReloader, NULL);
+	pthread_detach(reloaderThreadId);
+
+	//start the thread that pushes game events to /events subscribers
+	pthread_create(&sseThreadId, NULL, sseBroadcaster, NULL);
+	pthread_detach(sseThreadId);
+	//start the thread that keeps the scores and the leaderboard
+	pthread_create(&scoreThreadId, NULL, scoreKeeper, NULL);
+	pthread_detach(scoreThreadId);
+	//a restored board may have been finished with its successor already prepared
+	if (isRestored == 1){
+		tryRollover();
+	}
+
+	//start the thread that keeps the snapshot up to date
+	if (snapshotPath != NULL){
+		pthread_create(&snapshotThreadId, NULL, snapshotWriter, NULL);
+		pthread_detach(snapshotThreadId);
+	}
+	//start the thread that brings in what the other processes change, even while no request comes
+	if (sharedGame != NULL){
+		pthread_create(&followerThreadId, NULL, sharedGameFollower, NULL);
+		pthread_detach(followerThreadId);
+	}
+
+	//Server socket create, Server Setup: every listener binds the same port (SO_REUSEPORT when
+	//there are several, or other processes share the game) and gets its own pending queue and
+	//worker slots, all set to available
+	for (int i = 0; i < LISTENER_COUNT; i++){
+		listener[i].index = i;
+		listener[i].socket = serverSocketCreate(LISTENER_COUNT > 1 || sharedGame != NULL);
+		listener[i].pending = (struct pendingConnection *)malloc(sizeof(struct pendingConnection) * PENDING_QUEUE_SIZE);
+		if (listener[i].socket == -1 || listener[i].pending == NULL){
+			fprintf(stderr, "Could not listen on port %s\n", PORT_NUMBER);
+			return 1;
+		}
+		pthread_mutex_init(&listener[i].lock, NULL);
+		initTimerWheel(&listener[i].wheel, nowNanoseconds());
+		if (pipe(listener[i].wakePipe) == -1){
+			fprintf(stderr, "Could not create the wake pipe of listener %d\n", i);
+			return 1;
+		}
+		fcntl(listener[i].wakePipe[0], F_SETFL, O_NONBLOCK);
+		fcntl(listener[i].wakePipe[1], F_SETFL, O_NONBLOCK);
+		fcntl(listener[i].socket, F_SETFL, O_NONBLOCK);
+		for (int j = 0; j < WORKERS_PER_LISTENER; j++){
+			listener[i].thread[j].isDone = 1;
+			listener[i].thread[j].owner = &listener[i];
+		}
+	}
+	LOG(LOG_INFO, "event=listening port=%s listeners=%d backlog=%d queue=%d per_client=%d timeout_s=%d", PORT_NUMBER,
+		LISTENER_COUNT, BACKLOG, PENDING_QUEUE_SIZE, MAX_CLIENT_CONNECTIONS, CLIENT_TIMEOUT);
+	//one acceptor thread per extra listener, the main thread accepts on the first one
+	for (int i = 1; i < LISTENER_COUNT; i++){
+		pthread_create(&listener[i].acceptorId, NULL, acceptConnections, &listener[i]);
+		pthread_detach(listener[i].acceptorId);
+	}
+	listener[0].acceptorId = pthread_self();
+	acceptConnections(&listener[0]);
+	return 0;
+}
+/*
+ * Function: acceptConnections
+ * ---------------------------
+ * I/O loop of one listener: waits for client connect requests on the listener's socket and
+ * hands each one to admitConnection, and expires the deadlines in the listener's timer wheel
+ * in one batch per pass. While deadlines are armed it wakes every wheel tick, otherwise it
+ * sleeps until a connection arrives or armTimeout writes to the wake pipe.
+ * Rollover is driven by the guess that completes the board, never by this loop.
+ *
+ * Parameters:
+ *      value - void pointer to the struct listener to serve
+ *
+ * Return:
+ *      void* - Returns NULL when the listening socket fails for good.
+ */
+void *acceptConnections(void *value){
+	struct listener *owner = (struct listener *)value;
+	int clientSocket, waitMilliseconds;
+	struct sockaddr_in clientSocketAddress;
+	socklen_t clientSocketAddressSize;
+	struct pollfd ready[2];
+	char wake[64];
+
+	ready[0].fd = owner->socket;
+	ready[0].events = POLLIN;
+	ready[1].fd = owner->wakePipe[0];
+	ready[1].events = POLLIN;
 	while (1){
-		//if All words are guessed 
-		if (isDone() == 1){
-			//cleanUp the GameList
-			cleanupGameListNode();
-			//generate a new master word
-			masterWord = getRandomWord(wordRoot, wordPositionInDictionary);
-			//find all possible word that can formed by uses the letters of master word
-			findWords(masterWord->str);
-			setAllWordsToNotFound();
-		}
-
-		//accept client's connection 
-		clientSocket = accept(serverSocket, (struct sockaddr *)&clientSocketAddress, &clientSocketAddressSize);
-		//error check
-		if (clientSocket == -1){
-			printf("Client socket error\n");
-		}
-
-		//if there exist available thread to handle client
-		if (isThreadAvailable() == 1){
-			for (int i = 0; i < 8; i++){
-				if (thread[i].isDone == 1){
-					//create a new thread to handle client's request 
-					pthread_create(&thread[i].id, NULL, findFile, (void *)(intptr_t)clientSocket);
-					//set current thread status to busy
-					thread[i].isDone = 0;
-					//thread will clean up after thread is complete 
-					pthread_detach(thread[i].id);
+		pthread_mutex_lock(&owner->lock);
+		waitMilliseconds = owner->wheel.armedCount > 0 ? (int)(WHEEL_TICK_NANOSECONDS / 1000000) : -1;
+		owner->isSleeping = waitMilliseconds == -1;
+		pthread_mutex_unlock(&owner->lock);
+		if (poll(ready, 2, waitMilliseconds) == -1 && errno != EINTR){
+			LOG(LOG_ERROR, "event=poll_error listener=%d errno=%d", owner->index, errno);
+			break;
+		}
+		if (ready[1].revents & POLLIN){
+			while (read(owner->wakePipe[0], wake, sizeof(wake)) > 0){
+			}
+		}
+
+		// Expire every deadline that came due since the last pass, in one batch
+		pthread_mutex_lock(&owner->lock);
+		owner->isSleeping = 0;
+		expireTimers(&owner->wheel, nowNanoseconds(), expireConnection, NULL);
+		pthread_mutex_unlock(&owner->lock);
+
+		//accept every client's connection that is waiting (the listening socket does not block)
+		while (ready[0].revents & POLLIN){
+			clientSocketAddressSize = sizeof(clientSocketAddress);
+			clientSocket = accept(owner->socket, (struct sockaddr *)&clientSocketAddress, &clientSocketAddressSize);
+			//error check
+			if (clientSocket == -1){
+				if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR){
 					break;
 				}
+				LOG(LOG_ERROR, "event=accept_error listener=%d errno=%d", owner->index, errno);
+				if (errno == EBADF || errno == EINVAL || errno == ENOTSOCK){
+					close(owner->socket);
+					return NULL;
+				}
+				break;
+			}
+			atomic_fetch_add_explicit(&connectionsTotal, 1, memory_order_relaxed);
+			atomic_fetch_add_explicit(&owner->connections, 1, memory_order_relaxed);
+
+			//queue the connection for the listener's workers, or let the client know to come back later
+			if (admitConnection(owner, clientSocket, clientSocketAddress.sin_addr.s_addr) == -1){
+				rejectConnection(clientSocket);
 			}
 		}
-		//send msg to client, let client know all threads are currently busy
-		else{
-			send(clientSocket, serverFullMsg, strlen(serverFullMsg), 0);
+	}
+	close(owner->socket);
+	return NULL;
+}
+/*
+ * Function: admitConnection
+ * -------------------------
+ * Admission control for one accepted connection. The connection is refused when its
+ * client address is at MAX_CLIENT_CONNECTIONS or when the listener's queue is full;
+ * otherwise it is queued with a QUEUE_DEADLINE_MS deadline and, if one of the listener's
+ * worker slots is available, a new worker thread is started on it (busy workers pick the
+ * queue up when they finish).
+ *
+ * Parameters:
+ *      owner        - listener the connection was accepted on
+ *      clientSocket - accepted client socket
+ *      address      - client IPv4 address (network byte order)
+ *
+ * Return:
+ *      int - Returns 0 if the connection was queued, or -1 if it must be rejected.
+ */
+int admitConnection(struct listener *owner, int clientSocket, uint32_t address){
+	struct pendingConnection *connection;
+
+	if (admitClient(address) == 0){
+		atomic_fetch_add_explicit(&clientLimitedTotal, 1, memory_order_relaxed);
+		return -1;
+	}
+	pthread_mutex_lock(&owner->lock);
+	if (owner->pendingCount == PENDING_QUEUE_SIZE){
+		pthread_mutex_unlock(&owner->lock);
+		releaseClient(address);
+		atomic_fetch_add_explicit(&rejectedTotal, 1, memory_order_relaxed);
+		return -1;
+	}
+	connection = &owner->pending[(owner->pendingHead + owner->pendingCount) % PENDING_QUEUE_SIZE];
+	connection->socket = clientSocket;
+	connection->address = address;
+	connection->acceptedAt = nowNanoseconds();
+	connection->deadline.socket = clientSocket;
+	connection->deadline.kind = TIMEOUT_QUEUE;
+	connection->deadline.fired = 0;
+	connection->deadline.timer.next = NULL;
+	armTimer(&owner->wheel, &connection->deadline.timer, connection->acceptedAt + QUEUE_DEADLINE_MS * 1000000ULL);
+	owner->pendingCount++;
+
+	//if there exist available thread to handle client
+	if (isThreadAvailable(owner) == 1){
+		for (int i = 0; i < WORKERS_PER_LISTENER; i++){
+			if (owner->thread[i].isDone == 1){
+				//create a new thread to drain the queue, it sets the slot available again when it runs dry
+				owner->thread[i].isDone = 0;
+				if (pthread_create(&owner->thread[i].id, NULL, connectionWorker, &owner->thread[i]) != 0){
+					LOG(LOG_ERROR, "event=thread_create_error listener=%d", owner->index);
+					owner->thread[i].isDone = 1;
+					break;
+				}
+				//thread will clean up after thread is complete
+				pthread_detach(owner->thread[i].id);
+				break;
+			}
 		}
 	}
-	close(serverSocket);
+	pthread_mutex_unlock(&owner->lock);
 	return 0;
 }
+/*
+ * Function: connectionWorker
+ * --------------------------
+ * Worker thread of one slot: serves connections from its listener's queue until the queue
+ * is empty, then marks the slot available (under the lock the acceptor queues with, so
+ * no connection is left behind). Connections whose queue deadline expired were already
+ * answered 503 by the acceptor and are only closed. Each served connection starts with
+ * the slot's deadline armed for the request head.
+ *
+ * Parameters:
+ *      value - void pointer to the struct myThread slot this thread runs in
+ *
+ * Return:
+ *      void* - Returns NULL once the queue is empty.
+ */
+void *connectionWorker(void *value){
+	struct myThread *slot = (struct myThread *)value;
+	struct listener *owner = slot->owner;
+	struct pendingConnection *queued;
+	int clientSocket, expired;
+	uint32_t address;
+	unsigned long long acceptedAt;
+
+	workerSlot = slot;
+	while (1){
+		pthread_mutex_lock(&owner->lock);
+		if (owner->pendingCount == 0){
+			// Mark the current thread as done by setting isDone to 1
+			slot->isDone = 1;
+			pthread_mutex_unlock(&owner->lock);
+			return NULL;
+		}
+		queued = &owner->pending[owner->pendingHead];
+		cancelTimer(&owner->wheel, &queued->deadline.timer);
+		clientSocket = queued->socket;
+		address = queued->address;
+		acceptedAt = queued->acceptedAt;
+		expired = queued->deadline.fired;
+		owner->pendingHead = (owner->pendingHead + 1) % PENDING_QUEUE_SIZE;
+		owner->pendingCount--;
+		slot->deadline.socket = clientSocket;
+		pthread_mutex_unlock(&owner->lock);
+
+		if (expired == 1){
+			close(clientSocket);
+		}
+		else{
+			observeLatency(&queueWaitHistogram, acceptedAt);
+			armTimeout(TIMEOUT_HEADER);
+			slot->address = address;
+			findFile((void *)(intptr_t)clientSocket);
+		}
+		releaseClient(address);
+	}
+}
+/*
+ * Function: rejectConnection
+ * --------------------------
+ * Answers a connection with 503 Service Unavailable and Retry-After, then closes it.
+ * Never blocks: what the client already sent is drained first (closing over unread data
+ * resets the connection before the answer arrives), and the answer is only sent if it
+ * fits into the socket buffer right away.
+ *
+ * Parameters:
+ *      clientSocket - client socket to turn away
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void rejectConnection(int clientSocket){
+	char drain[1024];
 
+	while (recv(clientSocket, drain, sizeof(drain), MSG_DONTWAIT) > 0){
+	}
+	send(clientSocket, serverFullMsg, strlen(serverFullMsg), MSG_DONTWAIT | MSG_NOSIGNAL);
+	shutdown(clientSocket, SHUT_WR);
+	close(clientSocket);
+}
+/*
+ * Function: admitClient
+ * ---------------------
+ * Counts one more connection for a client address, unless the address already holds
+ * MAX_CLIENT_CONNECTIONS connections.
+ *
+ * Parameters:
+ *      address - client IPv4 address (network byte order)
+ *
+ * Return:
+ *      int - Returns 1 if the connection is admitted, or 0 if the address is at its cap.
+ */
+int admitClient(uint32_t address){
+	struct clientAddress **bucket = &clientTable[(address * 2654435761u) % CLIENT_TABLE_SIZE];
+	struct clientAddress *client;
+	int admitted = 1;
+
+	pthread_mutex_lock(&clientTableLock);
+	for (client = *bucket; client != NULL && client->address != address; client = client->next){
+	}
+	if (client == NULL){
+		client = (struct clientAddress *)malloc(sizeof(struct clientAddress));
+		if (client != NULL){
+			client->address = address;
+			client->connections = 0;
+			client->next = *bucket;
+			*bucket = client;
+		}
+	}
+	if (client == NULL || client->connections >= MAX_CLIENT_CONNECTIONS){
+		admitted = 0;
+	}
+	else{
+		client->connections++;
+	}
+	pthread_mutex_unlock(&clientTableLock);
+	return admitted;
+}
+/*
+ * Function: releaseClient
+ * -----------------------
+ * Counts one connection of a client address as finished, and forgets the address
+ * once it has none left.
+ *
+ * Parameters:
+ *      address - client IPv4 address (network byte order)
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void releaseClient(uint32_t address){
+	struct clientAddress **link = &clientTable[(address * 2654435761u) % CLIENT_TABLE_SIZE];
+	struct clientAddress *client;
+
+	pthread_mutex_lock(&clientTableLock);
+	while ((client = *link) != NULL && client->address != address){
+		link = &client->next;
+	}
+	if (client != NULL && --client->connections == 0){
+		*link = client->next;
+		free(client);
+	}
+	pthread_mutex_unlock(&clientTableLock);
+}
+/*
+ * Function: expireConnection
+ * --------------------------
+ * Timer wheel callback, run by the acceptor with the listener's lock held. A connection
+ * that waited too long in the queue is answered 503 and shut down (its worker only closes
+ * it). Any other expired connection is shut down under the worker blocked on it, which
+ * makes recv return 0 or send fail: for the request head and POST body only the reading
+ * side, so the worker can still answer 408.
+ *
+ * Parameters:
+ *      timer - the wheelTimer of an expired struct connectionTimer
+ *      value - unused
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void expireConnection(struct wheelTimer *timer, void *value){
+	struct connectionTimer *deadline = (struct connectionTimer *)timer;
+	char drain[1024];
+
+	deadline->fired = 1;
+	atomic_fetch_add_explicit(&timeoutTotal[deadline->kind], 1, memory_order_relaxed);
+	LOG(LOG_DEBUG, "event=timeout kind=%s", timeoutName[deadline->kind]);
+	if (deadline->kind == TIMEOUT_QUEUE){
+		while (recv(deadline->socket, drain, sizeof(drain), MSG_DONTWAIT) > 0){
+		}
+		send(deadline->socket, serverFullMsg, strlen(serverFullMsg), MSG_DONTWAIT | MSG_NOSIGNAL);
+		shutdown(deadline->socket, SHUT_RDWR);
+	}
+	else if (deadline->kind == TIMEOUT_WRITE){
+		shutdown(deadline->socket, SHUT_RDWR);
+	}
+	else{
+		shutdown(deadline->socket, SHUT_RD);
+	}
+}
+/*
+ * Function: armTimeout
+ * --------------------
+ * (Re)arms the calling worker's connection deadline, CLIENT_TIMEOUT seconds from now,
+ * and wakes the acceptor if it sleeps without a poll timeout. Does nothing outside a worker.
+ *
+ * Parameters:
+ *      kind - TIMEOUT_HEADER, TIMEOUT_BODY or TIMEOUT_WRITE
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void armTimeout(int kind){
+	struct listener *owner;
+
+	if (workerSlot == NULL){
+		return;
+	}
+	owner = workerSlot->owner;
+	pthread_mutex_lock(&owner->lock);
+	workerSlot->deadline.kind = kind;
+	workerSlot->deadline.fired = 0;
+	armTimer(&owner->wheel, &workerSlot->deadline.timer, nowNanoseconds() + CLIENT_TIMEOUT * 1000000000ULL);
+	if (owner->isSleeping == 1){
+		owner->isSleeping = 0;
+		if (write(owner->wakePipe[1], "", 1) == -1){
+			LOG(LOG_WARN, "event=wake_error listener=%d errno=%d", owner->index, errno);
+		}
+	}
+	pthread_mutex_unlock(&owner->lock);
+}
+/*
+ * Function: cancelTimeout
+ * -----------------------
+ * Disarms the calling worker's connection deadline. Must happen before the connection
+ * is closed or handed off, so the wheel never shuts down a reused descriptor.
+ *
+ * Return:
+ *      int - Returns 1 if the deadline had already expired, 0 otherwise.
+ */
+int cancelTimeout(){
+	struct listener *owner;
+	int fired;
+
+	if (workerSlot == NULL){
+		return 0;
+	}
+	owner = workerSlot->owner;
+	pthread_mutex_lock(&owner->lock);
+	cancelTimer(&owner->wheel, &workerSlot->deadline.timer);
+	fired = workerSlot->deadline.fired;
+	pthread_mutex_unlock(&owner->lock);
+	return fired;
+}
+/*
+ * Function: closeConnection
+ * -------------------------
+ * Disarms the calling worker's deadline and closes the client socket.
+ *
+ * Parameters:
+ *      clientSocket - client socket served by the calling worker
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void closeConnection(int clientSocket){
+	cancelTimeout();
+	close(clientSocket);
+}
 /*
  * Function: serverSocketCreate
  * ----------------------------
  * Initializes and creates a server socket, configures it to use IPv4 and TCP,
  * binds it to a specific port, and sets it to listen for incoming connections.
+ * SO_REUSEADDR lets a restarted server bind while old connections sit in TIME_WAIT;
+ * with reusePort several sockets share the port and the kernel balances connections among them.
+ *
+ * Parameters:
+ *      reusePort - 1 to set SO_REUSEPORT (one of several listeners), 0 otherwise
  *
  * Return:
  *      int - Returns the server socket descriptor if successful, or -1 if an error occurs.
  */
-int serverSocketCreate(){
+int serverSocketCreate(int reusePort){
 	// Local Variables 
-	int serverSocket;
-	struct addrinfo hint, *result, *currentPointer;
+	int serverSocket, enable = 1;
+	struct addrinfo hint, *result;
 
 	// Initialize server socket settings
 	memset(&hint, 0, sizeof(hint));
@@ -183,18 +933,35 @@ int serverSocketCreate(){
 	
 	// Get address information for the server
 	if (getaddrinfo(NULL, PORT_NUMBER, &hint, &result) != 0){
-		printf("Error getaddrinfo\n");
+		LOG(LOG_ERROR, "event=getaddrinfo_error port=%s", PORT_NUMBER);
+		return -1;
 	}
 	
 	// Create server socket using the specified protocol
 	serverSocket = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
 	if (serverSocket == -1){
-		printf("Server Socket Error\n");
+		LOG(LOG_ERROR, "event=socket_error errno=%d", errno);
+		freeaddrinfo(result);
+		return -1;
+	}
+
+	// Allow the rebind over TIME_WAIT, and sharing the port between listeners
+	if (setsockopt(serverSocket, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) == -1){
+		LOG(LOG_WARN, "event=setsockopt_error option=SO_REUSEADDR errno=%d", errno);
+	}
+	if (reusePort == 1 && setsockopt(serverSocket, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) == -1){
+		LOG(LOG_ERROR, "event=setsockopt_error option=SO_REUSEPORT errno=%d", errno);
+		freeaddrinfo(result);
+		close(serverSocket);
+		return -1;
 	}
 
 	// Bind the socket to the provided address
 	if (bind(serverSocket, result->ai_addr, result->ai_addrlen) == -1){
-		perror("Binding Error\n");
+		LOG(LOG_ERROR, "event=bind_error port=%s error=\"%s\"", PORT_NUMBER, strerror(errno));
+		freeaddrinfo(result);
+		close(serverSocket);
+		return -1;
 	}
 	
 	//free allicated memory	
@@ -202,16 +969,18 @@ int serverSocketCreate(){
 
 	// Set the socket to listen for incoming connections
 	if (listen(serverSocket, BACKLOG) == -1){
-		printf("Listen Error\n");
+		LOG(LOG_ERROR, "event=listen_error errno=%d", errno);
+		close(serverSocket);
+		return -1;
 	}
 	return serverSocket;
 }
-
 /*
  * Function: findFile
  * ------------------
  * Handles a client request to locate a file or process a word-guessing game query.
- * Runs in a new thread for each client connection, processes the request, and sends a response.
+ * Runs in a worker thread for each client connection taken from the listener's queue, processes
+ * the request, and sends a response.
  *
  * If a file is requested, it checks if the file exists and sends it. If not, returns a 404 error.
  * For game requests, it processes user input, updates the game, and sends an updated HTML page.
@@ -229,56 +998,182 @@ int serverSocketCreate(){
  * 4. Parse "GET" request.
  * 5. Handle file or game request.
  * 6. Construct and send response.
- * 7. Mark thread complete and clean up.
+ * 7. Clean up (the worker then moves on to the next queued connection).
  */
 void *findFile(void *value) {
 	// Local variables
-	pthread_t currentThreadId = pthread_self();
 	DIR *dir;
-	int clientSocket, fileExist = 0, userInputDetected = 0;
-	char buffer[BUFFER_SIZE], *token, *tokSavePtr;
+	int clientSocket, fileExist = 0, userInputDetected = 0, isPost = 0, encoding;
+	char buffer[BUFFER_SIZE], *token, *tokSavePtr, *body, *headers, tag[64];
+	const char *pageContent;
+	size_t pageLength;
+	struct puzzle *puzzle;
+	struct renderedPage *page;
+	ssize_t received;
+	long contentLength;
 	char fileNotFoundMsg[100] = "HTTP/1.1 404 Not Found\r\nContent-Length: 13\r\n\r\n404 Not Found";
 	char badRequestMsg[100] = "HTTP/1.0 400 Bad Request\r\nContent-Length: 15\r\n\r\n400 Bad Request";
+	char timeoutMsg[100] = "HTTP/1.1 408 Request Timeout\r\nConnection: close\r\nContent-Length: 19\r\n\r\n408 Request Timeout";
+	char notModifiedMsg[150];
 	struct dirent *filePtr = NULL;
 	struct stat fileStat;
+	unsigned long long start, stageStart;
+
+	// Tag everything this thread logs with a fresh request id
+	start = nowNanoseconds();
+	logRequestId = atomic_fetch_add(&requestCounter, 1) + 1;
 
 	// Retrieve client socket from passing value
 	clientSocket = (int)(intptr_t)value;
 	if (clientSocket == -1) {
-		printf("Client socket error\n");
+		LOG(LOG_ERROR, "event=client_socket_error");
 		return NULL;
 	}
 
 	// Open the directory specified by PATH
 	dir = opendir(PATH);
 	if (dir == NULL) {
-		printf("Directory open error\n");
+		LOG(LOG_ERROR, "event=opendir_error path=%s", PATH);
 		send(clientSocket, fileNotFoundMsg, strlen(fileNotFoundMsg), 0);
-		close(clientSocket);
+		closeConnection(clientSocket);
 		return NULL;
 	}
 
 	// Receive request message from the client
-	if (recv(clientSocket, buffer, BUFFER_SIZE, 0) == -1) {
-		printf("Recv Error\n");
+	received = recv(clientSocket, buffer, BUFFER_SIZE - 1, 0);
+	// A client that sent nothing within CLIENT_TIMEOUT had its reading side shut down by the wheel
+	if (cancelTimeout() == 1 && received <= 0) {
+		send(clientSocket, timeoutMsg, strlen(timeoutMsg), MSG_DONTWAIT | MSG_NOSIGNAL);
+		finishRequest("-", 408, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
 	}
+	if (received == -1) {
+		LOG(LOG_WARN, "event=recv_error errno=%d", errno);
+		received = 0;
+	}
+	buffer[received] = '\0';
+	// From here on the deadline covers processing and sending the response
+	armTimeout(TIMEOUT_WRITE);
+
+	// Locate the header lines, the body and its length before the request line gets tokenized
+	headers = strstr(buffer, "\r\n");
+	headers = headers ? headers : buffer + received;
+	body = strstr(buffer, "\r\n\r\n");
+	body = body ? body + 4 : buffer + received;
+	contentLength = getContentLength(buffer);
+	encoding = acceptedEncoding(buffer);
 
 	// Get the first part of the request (e.g., "GET")
 	token = strtok_r(buffer, " ", &tokSavePtr);
-	// Terminate the thread if the message does not start with "GET"
-	if (strcmp(token, "GET") != 0 && strcmp(token, "get") != 0) {
+	if (token != NULL && (strcmp(token, "POST") == 0 || strcmp(token, "post") == 0)) {
+		isPost = 1;
+	}
+	// Terminate the thread if the message does not start with "GET" (POST is only for /batch and /validate)
+	if (token == NULL || (strcmp(token, "GET") != 0 && strcmp(token, "get") != 0 && isPost == 0)) {
 		send(clientSocket, badRequestMsg, strlen(badRequestMsg), 0);
-		close(clientSocket);
+		finishRequest("-", 400, start);
+		closeConnection(clientSocket);
 		closedir(dir);
 		return NULL;
 	}
 
 	// Assign the second part of the request (file path) to token
 	token = strtok_r(NULL, " ", &tokSavePtr);
+	if (token == NULL) {
+		send(clientSocket, badRequestMsg, strlen(badRequestMsg), 0);
+		finishRequest("-", 400, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
 	// Remove leading '/' from the file path if it exists
 	if (token[0] == '/') {
 		token++; // Increment pointer to skip the first character
 	}
+	observeLatency(&stageHistogram[STAGE_RECV_PARSE], start);
+	identifyPlayer(strchr(token, '?'));
+
+	// Prometheus scrape of the counters and stage histograms
+	if (strcmp(token, "metrics") == 0) {
+		size_t metricsLength;
+		char *metrics = renderMetrics(&metricsLength);
+		if (metrics != NULL) {
+			char metricsHeader[150];
+			snprintf(metricsHeader, sizeof(metricsHeader), "HTTP/1.1 200 OK\r\n"
+				"Content-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n", metricsLength);
+			send(clientSocket, metricsHeader, strlen(metricsHeader), MSG_NOSIGNAL);
+			send(clientSocket, metrics, metricsLength, MSG_NOSIGNAL);
+			free(metrics);
+		}
+		finishRequest(token, 200, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+
+	// Live update stream: hand the socket over to the broadcaster and free this thread
+	if (strcmp(token, "events") == 0) {
+		cancelTimeout();
+		if (sseSubscribe(clientSocket) == -1) {
+			closeConnection(clientSocket);
+		}
+		finishRequest(token, 200, start);
+		closedir(dir);
+		return NULL;
+	}
+
+	// Leaderboard as last rendered by the score keeper
+	if (isPost == 0 && strcmp(token, "leaderboard") == 0) {
+		handleLeaderboard(clientSocket, encoding);
+		finishRequest(token, 200, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+
+	// Batched guesses: GET /batch?move=a&move=b or POST /batch with the guesses in the body
+	if (strncmp(token, "batch", 5) == 0 && (token[5] == '\0' || token[5] == '?')) {
+		puzzle = acquirePuzzle();
+		handleBatch(puzzle, clientSocket, token[5] == '?' ? token + 6 : NULL,
+			isPost ? body : NULL, buffer + received - body, contentLength);
+		releasePuzzle(puzzle);
+		finishRequest("batch", 200, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+	// Hint on the current board: GET /hint?length=5&prefix=TR[&reveal=1]
+	if (isPost == 0 && strncmp(token, "hint", 4) == 0 && (token[4] == '\0' || token[4] == '?')) {
+		puzzle = acquirePuzzle();
+		handleHint(puzzle, clientSocket, token[4] == '?' ? token + 5 : NULL);
+		releasePuzzle(puzzle);
+		finishRequest("hint", 200, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+
+	// Word validation against a rack, no puzzle involved: GET /validate?rack=abc&word=a or POST the words
+	if (strncmp(token, "validate", 8) == 0 && (token[8] == '\0' || token[8] == '?')) {
+		handleValidate(clientSocket, token[8] == '?' ? token + 9 : NULL, isPost ? body : NULL,
+			buffer + received - body, contentLength);
+		finishRequest("validate", 200, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+	if (isPost == 1) {
+		send(clientSocket, badRequestMsg, strlen(badRequestMsg), 0);
+		finishRequest(token, 400, start);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+
+	// Hold on to the current puzzle for the whole request, a rollover cannot free it under us
+	puzzle = acquirePuzzle();
 
 	// Split the file path and query part if there is a '?'(user enter their guess)
 	char *query = strchr(token, '?');
@@ -307,39 +1202,426 @@ void *findFile(void *value) {
 		// Parse the query parameters
 		char *key = strtok(query, "=");
 		char *value = strtok(NULL, "=");
+		// Other fields (player=) follow the guess
+		if (value != NULL){
+			value[strcspn(value, "&")] = '\0';
+		}
 		//if key and value are not NULL, and key == move 
 		if (key && value && strcmp(key, "move") == 0) {
-			printf("Received Value: %s\n", value); // Debug
-			acceptInput(value);
+			stageStart = nowNanoseconds();
+			acceptInput(puzzle, value);
+			observeLatency(&stageHistogram[STAGE_ACCEPT_INPUT], stageStart);
 			userInputDetected = 1;
 		}
 	}
 
-	//get formated master word and html_ized game content (both malloc)
-	masterWordHolder = displayWord(masterWord->str);
-	wordBuffer = displayGameList(gameRoot);
-	if (masterWordHolder == NULL || wordBuffer == NULL){
-		printf("error check\n");
-		close(clientSocket);
+	//if file not exist or url is not send back by user's input (a finished board shows its congratulations page)
+	if (fileExist == 0 && userInputDetected == 0 && isDone(puzzle) == 0) {
+		// File not found, send 404 response
+		send(clientSocket, fileNotFoundMsg, strlen(fileNotFoundMsg), 0);
+		finishRequest(token, 404, start);
+		releasePuzzle(puzzle);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+
+	// The client still shows this very state: answer from the headers alone, nothing is rendered
+	entityTag(tag, sizeof(tag), puzzle->id, atomic_load(&gameStateVersion), encoding);
+	if (isNotModified(headers, tag) == 1) {
+		snprintf(notModifiedMsg, sizeof(notModifiedMsg), "HTTP/1.1 304 Not Modified\r\nETag: %s\r\n"
+			"Cache-Control: no-cache\r\nVary: Accept-Encoding\r\n\r\n", tag);
+		send(clientSocket, notModifiedMsg, strlen(notModifiedMsg), MSG_NOSIGNAL);
+		finishRequest(token, 304, start);
+		releasePuzzle(puzzle);
+		closeConnection(clientSocket);
+		closedir(dir);
+		return NULL;
+	}
+
+	//html_ized game content, rendered and compressed once per game state version
+	page = acquirePage(puzzle);
+	if (page == NULL){
+		LOG(LOG_ERROR, "event=render_error");
+		releasePuzzle(puzzle);
+		closeConnection(clientSocket);
 		closedir(dir);
 		return NULL;
 	}
+	encoding = pageBody(page, encoding, &pageContent, &pageLength);
+	// Tag what is actually sent: the version the page was rendered at, and its encoding
+	entityTag(tag, sizeof(tag), page->puzzleId, page->version, encoding);
+
+	// construct HTTP response header
+	// (built in its own buffer, the request buffer still holds the path)
+	char header[300];
+	snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=UTF-8\r\n"
+		"Content-Length: %zu\r\nETag: %s\r\nCache-Control: no-cache\r\nVary: Accept-Encoding\r\n%s%s%s\r\n", pageLength, tag,
+		encoding != ENCODING_IDENTITY ? "Content-Encoding: " : "", encoding != ENCODING_IDENTITY ? encodingName[encoding] : "",
+		encoding != ENCODING_IDENTITY ? "\r\n" : "");
+	// Send the header and HTML_ized game content
+	stageStart = nowNanoseconds();
+	send(clientSocket, header, strlen(header), MSG_NOSIGNAL);
+	send(clientSocket, pageContent, pageLength, MSG_NOSIGNAL);
+	observeLatency(&stageHistogram[STAGE_SEND], stageStart);
+	atomic_fetch_add_explicit(&pageBytesTotal[encoding], pageLength, memory_order_relaxed);
+	finishRequest(token, 200, start);
+
+	// clean up 
+	releasePage(page);
+	releasePuzzle(puzzle);
+	closeConnection(clientSocket);
+	closedir(dir);
+	return NULL;
+}
+/*
+ * Function: finishRequest
+ * -----------------------
+ * Records a finished request: access log line, request latency histogram,
+ * status counters and worker busy time.
+ *
+ * Parameters:
+ *      path   - requested path (without the leading '/')
+ *      status - HTTP status sent to the client
+ *      start  - nowNanoseconds() when the request started
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void finishRequest(const char *path, int status, unsigned long long start){
+	unsigned long long elapsed = nowNanoseconds() - start;
+
+	observeLatency(&requestHistogram, start);
+	atomic_fetch_add_explicit(&workerBusyNanoseconds, elapsed, memory_order_relaxed);
+	if (status == 404){
+		atomic_fetch_add_explicit(&notFoundTotal, 1, memory_order_relaxed);
+	}
+	else if (status == 400){
+		atomic_fetch_add_explicit(&badRequestTotal, 1, memory_order_relaxed);
+	}
+	else if (status == 304){
+		atomic_fetch_add_explicit(&notModifiedTotal, 1, memory_order_relaxed);
+	}
+	LOG(LOG_INFO, "event=request path=%s status=%d latency_us=%llu", path, status, elapsed / 1000);
+}
+/*
+ * Function: renderMetrics
+ * -----------------------
+ * Renders every counter, gauge and histogram in Prometheus text exposition format.
+ *
+ * Parameters:
+ *      length - receives the length of the rendered text
+ *
+ * Return:
+ *      char* - malloc'd text, or NULL if an allocation failed.
+ */
+char *renderMetrics(size_t *length){
+	size_t size = 16384;
+	char *text = (char *)malloc(size);
+	char label[40];
+	int busy = 0, pending = 0, armed = 0;
+	struct scoreTotals scores;
+
+	*length = 0;
+	// The gauges are guarded by each listener's lock, like everything its acceptor and workers share
+	for (int i = 0; i < LISTENER_COUNT; i++){
+		pthread_mutex_lock(&listener[i].lock);
+		for (int j = 0; j < WORKERS_PER_LISTENER; j++){
+			if (listener[i].thread[j].isDone == 0){
+				busy++;
+			}
+		}
+		pending += listener[i].pendingCount;
+		armed += listener[i].wheel.armedCount;
+		pthread_mutex_unlock(&listener[i].lock);
+	}
+
+	appendText(&text, length, &size, "# HELP wwf_connections_total Connections accepted.\n# TYPE wwf_connections_total counter\n"
+		"wwf_connections_total %lu\n", atomic_load(&connectionsTotal));
+	appendText(&text, length, &size, "# HELP wwf_rejected_total Connections answered 503 because every worker was busy and the queue was full.\n"
+		"# TYPE wwf_rejected_total counter\nwwf_rejected_total %lu\n", atomic_load(&rejectedTotal));
+	appendText(&text, length, &size, "# HELP wwf_client_limited_total Connections answered 503 because their address held too many.\n"
+		"# TYPE wwf_client_limited_total counter\nwwf_client_limited_total %lu\n", atomic_load(&clientLimitedTotal));
+	appendText(&text, length, &size, "# HELP wwf_timeouts_total Connection deadlines expired by the timer wheels: queue (answered 503),"
+		" header (408), body and write.\n# TYPE wwf_timeouts_total counter\n");
+	for (int i = 0; i < TIMEOUT_KINDS; i++){
+		appendText(&text, length, &size, "wwf_timeouts_total{kind=\"%s\"} %lu\n", timeoutName[i], atomic_load(&timeoutTotal[i]));
+	}
+	appendText(&text, length, &size, "# HELP wwf_not_found_total Requests answered with 404.\n# TYPE wwf_not_found_total counter\n"
+		"wwf_not_found_total %lu\n", atomic_load(&notFoundTotal));
+	appendText(&text, length, &size, "# HELP wwf_bad_request_total Requests answered with 400.\n# TYPE wwf_bad_request_total counter\n"
+		"wwf_bad_request_total %lu\n", atomic_load(&badRequestTotal));
+	appendText(&text, length, &size, "# HELP wwf_rollovers_total Completed puzzles replaced by a new one.\n# TYPE wwf_rollovers_total counter\n"
+		"wwf_rollovers_total %lu\n", atomic_load(&rolloverTotal));
+	appendText(&text, length, &size, "# HELP wwf_listener_connections_total Connections accepted per listening socket.\n"
+		"# TYPE wwf_listener_connections_total counter\n");
+	for (int i = 0; i < LISTENER_COUNT; i++){
+		appendText(&text, length, &size, "wwf_listener_connections_total{listener=\"%d\"} %lu\n", i,
+			atomic_load(&listener[i].connections));
+	}
+	appendText(&text, length, &size, "# HELP wwf_workers Worker thread slots.\n# TYPE wwf_workers gauge\nwwf_workers %d\n",
+		LISTENER_COUNT * WORKERS_PER_LISTENER);
+	appendText(&text, length, &size, "# HELP wwf_workers_busy Worker thread slots currently serving a request.\n"
+		"# TYPE wwf_workers_busy gauge\nwwf_workers_busy %d\n", busy);
+	appendText(&text, length, &size, "# HELP wwf_pending_connections Admitted connections waiting for a worker.\n"
+		"# TYPE wwf_pending_connections gauge\nwwf_pending_connections %d\n", pending);
+	appendText(&text, length, &size, "# HELP wwf_armed_deadlines Connection deadlines armed in the timer wheels.\n"
+		"# TYPE wwf_armed_deadlines gauge\nwwf_armed_deadlines %d\n", armed);
+	appendText(&text, length, &size, "# HELP wwf_worker_busy_seconds_total Time workers spent serving requests; divide its rate by wwf_workers for utilization.\n"
+		"# TYPE wwf_worker_busy_seconds_total counter\nwwf_worker_busy_seconds_total %.6f\n", atomic_load(&workerBusyNanoseconds) / 1e9);
+	pthread_mutex_lock(&sseSubscriberLock);
+	appendText(&text, length, &size, "# HELP wwf_sse_subscribers Open /events streams.\n# TYPE wwf_sse_subscribers gauge\n"
+		"wwf_sse_subscribers %d\n", sseSubscriberCount);
+	pthread_mutex_unlock(&sseSubscriberLock);
+	appendText(&text, length, &size, "# HELP wwf_dictionary_reloads_total Word list reloads triggered by SIGHUP.\n"
+		"# TYPE wwf_dictionary_reloads_total counter\nwwf_dictionary_reloads_total{result=\"ok\"} %lu\n"
+		"wwf_dictionary_reloads_total{result=\"failed\"} %lu\n", atomic_load(&dictionaryReloadTotal),
+		atomic_load(&dictionaryReloadFailedTotal));
+	appendText(&text, length, &size, "# HELP wwf_hints_total Hint requests, and the words they revealed.\n"
+		"# TYPE wwf_hints_total counter\nwwf_hints_total{kind=\"query\"} %lu\nwwf_hints_total{kind=\"reveal\"} %lu\n",
+		atomic_load(&hintTotal), atomic_load(&hintRevealTotal));
+	appendText(&text, length, &size, "# HELP wwf_words_checked_total Candidate words checked against a rack by /validate.\n"
+		"# TYPE wwf_words_checked_total counter\nwwf_words_checked_total %lu\n", atomic_load(&wordsCheckedTotal));
+	appendText(&text, length, &size, "# HELP wwf_validate_seconds_total Time spent checking words; wwf_words_checked_total over it is words per second.\n"
+		"# TYPE wwf_validate_seconds_total counter\nwwf_validate_seconds_total %.6f\n", atomic_load(&validateNanoseconds) / 1e9);
+	appendText(&text, length, &size, "# HELP wwf_snapshots_total Game state snapshots written (-p).\n"
+		"# TYPE wwf_snapshots_total counter\nwwf_snapshots_total{result=\"ok\"} %lu\n"
+		"wwf_snapshots_total{result=\"failed\"} %lu\n", atomic_load(&snapshotTotal), atomic_load(&snapshotFailedTotal));
+	appendText(&text, length, &size, "# HELP wwf_shared_syncs_total Changes taken over from the shared game (-m).\n"
+		"# TYPE wwf_shared_syncs_total counter\nwwf_shared_syncs_total %lu\n", atomic_load(&sharedSyncTotal));
+	scoreTotals(&scores);
+	appendText(&text, length, &size, "# HELP wwf_scored_words_total Words credited to players.\n# TYPE wwf_scored_words_total counter\n"
+		"wwf_scored_words_total %lu\n# HELP wwf_scored_points_total Points credited to players.\n# TYPE wwf_scored_points_total counter\n"
+		"wwf_scored_points_total %lu\n# HELP wwf_score_events_dropped_total Score events lost to a full queue or a full player table.\n"
+		"# TYPE wwf_score_events_dropped_total counter\nwwf_score_events_dropped_total %lu\n", scores.words, scores.points, scores.dropped);
+	appendText(&text, length, &size, "# HELP wwf_game_state_version Shared game state version.\n# TYPE wwf_game_state_version gauge\n"
+		"wwf_game_state_version %lu\n", atomic_load(&gameStateVersion));
+	appendText(&text, length, &size, "# HELP wwf_page_renders_total Board pages rendered (once per game state version).\n"
+		"# TYPE wwf_page_renders_total counter\nwwf_page_renders_total %lu\n", atomic_load(&pageRenderTotal));
+	appendText(&text, length, &size, "# HELP wwf_page_cache_hits_total Board page requests served from the cached render.\n"
+		"# TYPE wwf_page_cache_hits_total counter\nwwf_page_cache_hits_total %lu\n", atomic_load(&pageCacheHitTotal));
+	appendText(&text, length, &size, "# HELP wwf_not_modified_total Board page requests answered 304 from If-None-Match.\n"
+		"# TYPE wwf_not_modified_total counter\nwwf_not_modified_total %lu\n", atomic_load(&notModifiedTotal));
+	appendText(&text, length, &size, "# HELP wwf_page_compressions_total Compressed board page variants built.\n"
+		"# TYPE wwf_page_compressions_total counter\n");
+	for (int i = ENCODING_GZIP; i < ENCODING_COUNT; i++){
+		appendText(&text, length, &size, "wwf_page_compressions_total{encoding=\"%s\"} %lu\n", encodingName[i],
+			atomic_load(&pageCompressTotal[i]));
+	}
+	appendText(&text, length, &size, "# HELP wwf_page_body_bytes_total Board page body bytes sent, by content encoding.\n"
+		"# TYPE wwf_page_body_bytes_total counter\n");
+	for (int i = 0; i < ENCODING_COUNT; i++){
+		appendText(&text, length, &size, "wwf_page_body_bytes_total{encoding=\"%s\"} %lu\n", encodingName[i],
+			atomic_load(&pageBytesTotal[i]));
+	}
+
+	appendText(&text, length, &size, "# HELP wwf_request_duration_seconds Time from connection hand-off to response sent.\n"
+		"# TYPE wwf_request_duration_seconds histogram\n");
+	appendHistogram(&text, length, &size, "wwf_request_duration_seconds", "", &requestHistogram);
+	appendText(&text, length, &size, "# HELP wwf_queue_wait_seconds Time from accept to a worker taking the connection.\n"
+		"# TYPE wwf_queue_wait_seconds histogram\n");
+	appendHistogram(&text, length, &size, "wwf_queue_wait_seconds", "", &queueWaitHistogram);
+	appendText(&text, length, &size, "# HELP wwf_stage_duration_seconds Time spent in each request and puzzle generation stage.\n"
+		"# TYPE wwf_stage_duration_seconds histogram\n");
+	for (int i = 0; i < STAGE_COUNT; i++){
+		snprintf(label, sizeof(label), "stage=\"%s\"", stageName[i]);
+		appendHistogram(&text, length, &size, "wwf_stage_duration_seconds", label, &stageHistogram[i]);
+	}
+	return text;
+}
+/*
+ * Function: getContentLength
+ * --------------------------
+ * Looks up the Content-Length header of a raw HTTP request.
+ *
+ * Parameters:
+ *      request - NUL-terminated request head as received from the client
+ *
+ * Return:
+ *      long - The declared body length, or 0 if the header is missing.
+ */
+long getContentLength(char *request){
+	char *line = strstr(request, "\r\n");
+
+	// Walk the header lines until the blank line that ends the head
+	while (line != NULL && line[2] != '\r' && line[2] != '\0'){
+		line += 2;
+		if (strncasecmp(line, "Content-Length:", 15) == 0){
+			return strtol(line + 15, NULL, 10);
+		}
+		line = strstr(line, "\r\n");
+	}
+	return 0;
+}
+/*
+ * Function: acceptedEncoding
+ * --------------------------
+ * Negotiates the response encoding from the Accept-Encoding header of a raw HTTP request.
+ * gzip is preferred over deflate; codings listed with q=0 are refused.
+ *
+ * Parameters:
+ *      request - NUL-terminated request head as received from the client
+ *
+ * Return:
+ *      int - ENCODING_GZIP, ENCODING_DEFLATE, or ENCODING_IDENTITY if neither is accepted.
+ */
+int acceptedEncoding(char *request){
+	char *line = strstr(request, "\r\n");
+	int accepted[ENCODING_COUNT] = {1, 0, 0};
+
+	// Walk the header lines until the blank line that ends the head
+	while (line != NULL && line[2] != '\r' && line[2] != '\0'){
+		line += 2;
+		if (strncasecmp(line, "Accept-Encoding:", 16) == 0){
+			char *coding = line + 16;
+			// One coding per comma: name, optionally followed by ;q=weight
+			while (*coding != '\0' && *coding != '\r'){
+				size_t nameLength;
+				char *parameter;
+				int isAccepted = 1;
+
+				coding += strspn(coding, " \t,");
+				nameLength = strcspn(coding, " \t;,\r");
+				parameter = coding + nameLength;
+				parameter += strspn(parameter, " \t");
+				if (*parameter == ';'){
+					parameter += 1 + strspn(parameter + 1, " \t");
+					if (strncasecmp(parameter, "q=", 2) == 0 && strtod(parameter + 2, NULL) == 0.0){
+						isAccepted = 0;
+					}
+				}
+				if ((nameLength == 4 && strncasecmp(coding, "gzip", 4) == 0) || (nameLength == 1 && *coding == '*')){
+					accepted[ENCODING_GZIP] = isAccepted;
+				}
+				else if (nameLength == 7 && strncasecmp(coding, "deflate", 7) == 0){
+					accepted[ENCODING_DEFLATE] = isAccepted;
+				}
+				coding += nameLength;
+				coding += strcspn(coding, ",\r");
+			}
+		}
+		line = strstr(line, "\r\n");
+	}
+	if (accepted[ENCODING_GZIP] == 1){
+		return ENCODING_GZIP;
+	}
+	if (accepted[ENCODING_DEFLATE] == 1){
+		return ENCODING_DEFLATE;
+	}
+	return ENCODING_IDENTITY;
+}
+/*
+ * Function: entityTag
+ * -------------------
+ * Formats the ETag of a board page: puzzle id and game state version, plus the content
+ * coding so a gzip body and a plain body of the same state never share a tag. The server
+ * start time comes first, a version number may repeat after a restart.
+ *
+ * Parameters:
+ *      tag      - receives the quoted tag
+ *      size     - size of tag
+ *      puzzleId - id of the puzzle shown
+ *      version  - gameStateVersion the page shows
+ *      encoding - ENCODING_* value of the body
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void entityTag(char *tag, size_t size, unsigned long puzzleId, unsigned long version, int encoding){
+	if (encoding == ENCODING_IDENTITY){
+		snprintf(tag, size, "\"%lx-%lu-%lu\"", serverEpoch, puzzleId, version);
+	}
+	else{
+		snprintf(tag, size, "\"%lx-%lu-%lu-%s\"", serverEpoch, puzzleId, version, encodingName[encoding]);
+	}
+}
+/*
+ * Function: isNotModified
+ * -----------------------
+ * Checks the If-None-Match header of a raw HTTP request against the current tag. The
+ * header may list several tags (comma separated, weak W/ tags compare by their value)
+ * or be "*".
+ *
+ * Parameters:
+ *      request - NUL-terminated request head (the header lines are enough)
+ *      tag     - quoted tag of the current page, from entityTag
+ *
+ * Return:
+ *      int - 1 if the client's copy is current, or 0 if the page must be sent.
+ */
+int isNotModified(char *request, const char *tag){
+	char *line = strstr(request, "\r\n");
+	size_t tagLength = strlen(tag);
+
+	// Walk the header lines until the blank line that ends the head
+	while (line != NULL && line[2] != '\r' && line[2] != '\0'){
+		line += 2;
+		if (strncasecmp(line, "If-None-Match:", 14) == 0){
+			char *candidate = line + 14;
+			while (*candidate != '\0' && *candidate != '\r'){
+				size_t candidateLength;
+
+				candidate += strspn(candidate, " \t,");
+				if (strncmp(candidate, "W/", 2) == 0){
+					candidate += 2;
+				}
+				candidateLength = strcspn(candidate, " \t,\r");
+				if ((candidateLength == 1 && *candidate == '*') ||
+					(candidateLength == tagLength && strncmp(candidate, tag, tagLength) == 0)){
+					return 1;
+				}
+				candidate += candidateLength;
+			}
+		}
+		line = strstr(line, "\r\n");
+	}
+	return 0;
+}
+/*
+ * Function: renderPage
+ * --------------------
+ * Renders the board page (or the congratulations page of a finished board) of a puzzle.
+ *
+ * Parameters:
+ *      puzzle  - puzzle to render
+ *      version - gameStateVersion read before rendering
+ *
+ * Return:
+ *      struct renderedPage* - New page with one reference, or NULL if an allocation failed.
+ */
+struct renderedPage *renderPage(struct puzzle *puzzle, unsigned long version){
+	struct renderedPage *page;
+	char *wordBuffer, *masterWordHolder, *html_buffer;
+	unsigned long long stageStart;
+	size_t required_size;
+
+	//get formated master word and html_ized game content (both malloc)
+	stageStart = nowNanoseconds();
+	masterWordHolder = displayWord(puzzle->masterWord);
+	observeLatency(&stageHistogram[STAGE_RENDER_WORD], stageStart);
+	stageStart = nowNanoseconds();
+	wordBuffer = displayGameList(puzzle->gameRoot);
+	observeLatency(&stageHistogram[STAGE_RENDER_BOARD], stageStart);
+	page = (struct renderedPage *)calloc(1, sizeof(struct renderedPage));
+	if (masterWordHolder == NULL || wordBuffer == NULL || page == NULL){
+		free(wordBuffer);
+		free(masterWordHolder);
+		free(page);
+		return NULL;
+	}
 
 	// Allocate memory for `html_buffer` with proper size (malloc)
-    	size_t required_size = BUFFER_SIZE + strlen(masterWordHolder) + strlen(wordBuffer) + 201;
-	char *html_buffer = (char *)malloc(required_size);
+	required_size = BUFFER_SIZE + strlen(masterWordHolder) + strlen(wordBuffer) + 201;
+	html_buffer = (char *)malloc(required_size);
 	if (html_buffer == NULL) {
-		fprintf(stderr, "Error: Memory allocation failed for html_buffer\n");
 		free(wordBuffer);
 		free(masterWordHolder);
-		free(html_buffer);
-		close(clientSocket);
-		closedir(dir);
+		free(page);
 		return NULL;
 	}
 
 	// if All words are guessed, response with different web Page.
-	if (isDone() == 1){
+	if (isDone(puzzle) == 1){
 		snprintf(html_buffer, required_size,
 			"<html>"
 			"<head>"
@@ -385,771 +1667,1258 @@ void *findFile(void *value) {
 			"  </body>\n"
 			"</html>\n",
 			masterWordHolder, wordBuffer);
-		//if file not exist or url is not send back by user's input 
-		if (fileExist == 0 && userInputDetected  == 0) {
-			// File not found, send 404 response
-			send(clientSocket, fileNotFoundMsg, strlen(fileNotFoundMsg), 0);
-			printf("%s not found!\n", token);
-			free(wordBuffer);
-			free(masterWordHolder);
-			free(html_buffer);
-			close(clientSocket);
-			closedir(dir);
-			return NULL;
+	}
+	free(wordBuffer);
+	free(masterWordHolder);
+
+	page->puzzleId = puzzle->id;
+	page->version = version;
+	page->body[ENCODING_IDENTITY] = html_buffer;
+	page->length[ENCODING_IDENTITY] = strlen(html_buffer);
+	pthread_mutex_init(&page->lock, NULL);
+	atomic_init(&page->refCount, 1);
+	atomic_fetch_add_explicit(&pageRenderTotal, 1, memory_order_relaxed);
+	return page;
+}
+/*
+ * Function: acquirePage
+ * ---------------------
+ * Returns the rendered page of the puzzle at the current game state version, rendering it
+ * only if the cached page is of an older version. A newer render replaces the cached page;
+ * a request still on a rolled-over puzzle gets a private render that is not cached.
+ *
+ * Parameters:
+ *      puzzle - puzzle the request holds
+ *
+ * Return:
+ *      struct renderedPage* - The page, hand it back with releasePage; NULL if rendering failed.
+ */
+struct renderedPage *acquirePage(struct puzzle *puzzle){
+	// Read the version first: a page is never labelled newer than what it shows
+	unsigned long version = atomic_load(&gameStateVersion);
+	struct renderedPage *page = NULL, *replaced = NULL;
+
+	pthread_mutex_lock(&pageLock);
+	if (cachedPage != NULL && cachedPage->puzzleId == puzzle->id && cachedPage->version == version){
+		page = cachedPage;
+		atomic_fetch_add(&page->refCount, 1);
+	}
+	pthread_mutex_unlock(&pageLock);
+	if (page != NULL){
+		atomic_fetch_add_explicit(&pageCacheHitTotal, 1, memory_order_relaxed);
+		return page;
+	}
+
+	page = renderPage(puzzle, version);
+	if (page == NULL){
+		return NULL;
+	}
+	pthread_mutex_lock(&pageLock);
+	if (cachedPage == NULL || cachedPage->version < version){
+		replaced = cachedPage;
+		cachedPage = page;
+		atomic_fetch_add(&page->refCount, 1);
+	}
+	pthread_mutex_unlock(&pageLock);
+	if (replaced != NULL){
+		releasePage(replaced);
+	}
+	return page;
+}
+/*
+ * Function: releasePage
+ * ---------------------
+ * Drops one reference to a rendered page, freeing it and its variants with the last one.
+ *
+ * Parameters:
+ *      page - page from acquirePage
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void releasePage(struct renderedPage *page){
+	if (atomic_fetch_sub(&page->refCount, 1) == 1){
+		for (int i = 0; i < ENCODING_COUNT; i++){
+			free(page->body[i]);
+		}
+		pthread_mutex_destroy(&page->lock);
+		free(page);
+	}
+}
+/*
+ * Function: pageBody
+ * ------------------
+ * Looks up the body of a page in an encoding, compressing it the first time that encoding
+ * is asked for (later requests for the same version reuse the result). Requests arriving
+ * while the variant is compressed wait for it instead of compressing it again.
+ *
+ * Parameters:
+ *      page     - rendered page
+ *      encoding - wanted ENCODING_* value
+ *      body     - receives the body
+ *      length   - receives the body length in bytes
+ *
+ * Return:
+ *      int - Encoding of the returned body: the wanted one, or ENCODING_IDENTITY if compression failed.
+ */
+int pageBody(struct renderedPage *page, int encoding, const char **body, size_t *length){
+	if (encoding != ENCODING_IDENTITY){
+		pthread_mutex_lock(&page->lock);
+		if (page->body[encoding] == NULL && page->compressFailed[encoding] == 0){
+			unsigned long long stageStart = nowNanoseconds();
+			page->body[encoding] = compressBody(page->body[ENCODING_IDENTITY], page->length[ENCODING_IDENTITY],
+				encoding, &page->length[encoding]);
+			observeLatency(&stageHistogram[STAGE_COMPRESS], stageStart);
+			if (page->body[encoding] == NULL){
+				LOG(LOG_WARN, "event=compress_error encoding=%s", encodingName[encoding]);
+				page->compressFailed[encoding] = 1;
+			}
+		}
+		pthread_mutex_unlock(&page->lock);
+		if (page->body[encoding] == NULL){
+			encoding = ENCODING_IDENTITY;
+		}
+	}
+	*body = page->body[encoding];
+	*length = page->length[encoding];
+	return encoding;
+}
+/*
+ * Function: compressBody
+ * ----------------------
+ * Compresses a response body with zlib, as a gzip member or as a zlib stream (what HTTP
+ * calls deflate).
+ *
+ * Parameters:
+ *      data     - body to compress
+ *      length   - body length in bytes
+ *      encoding - ENCODING_GZIP or ENCODING_DEFLATE
+ *      compressedLength - receives the compressed length
+ *
+ * Return:
+ *      char* - malloc'd compressed body, or NULL if an error occurs.
+ */
+char *compressBody(const char *data, size_t length, int encoding, size_t *compressedLength){
+	z_stream stream;
+	char *compressed;
+	uLong bound;
+
+	memset(&stream, 0, sizeof(stream));
+	// windowBits 15, plus 16 for the gzip wrapper
+	if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, encoding == ENCODING_GZIP ? 31 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK){
+		return NULL;
+	}
+	bound = deflateBound(&stream, length);
+	compressed = (char *)malloc(bound);
+	if (compressed == NULL){
+		deflateEnd(&stream);
+		return NULL;
+	}
+	stream.next_in = (Bytef *)data;
+	stream.avail_in = length;
+	stream.next_out = (Bytef *)compressed;
+	stream.avail_out = bound;
+	if (deflate(&stream, Z_FINISH) != Z_STREAM_END){
+		deflateEnd(&stream);
+		free(compressed);
+		return NULL;
+	}
+	*compressedLength = stream.total_out;
+	deflateEnd(&stream);
+	atomic_fetch_add_explicit(&pageCompressTotal[encoding], 1, memory_order_relaxed);
+	return compressed;
+}
+/*
+ * Function: collectGuesses
+ * ------------------------
+ * Splits a guess list into individual guesses. Accepts form encoding
+ * ("move=cat&move=dog") as well as one bare guess per line.
+ *
+ * Parameters:
+ *      list       - guess list, modified in place
+ *      key        - form field holding the guesses ("move"), other fields are ignored
+ *      guesses    - array receiving pointers to each guess
+ *      guessCount - number of guesses already stored in the array
+ *      maxGuesses - capacity of the array
+ *
+ * Return:
+ *      int - The new number of guesses stored in the array.
+ */
+int collectGuesses(char *list, const char *key, char **guesses, int guessCount, int maxGuesses){
+	char *savePtr, *value;
+
+	for (char *item = strtok_r(list, "&\r\n", &savePtr); item != NULL && guessCount < maxGuesses;
+			item = strtok_r(NULL, "&\r\n", &savePtr)){
+		value = strchr(item, '=');
+		// Only key parameters are guesses, other form fields are ignored
+		if (value != NULL){
+			*value = '\0';
+			if (strcmp(item, key) != 0){
+				continue;
+			}
+			item = value + 1;
+		}
+		if (item[0] != '\0'){
+			guesses[guessCount++] = item;
+		}
+	}
+	return guessCount;
+}
+/*
+ * Function: handleBatch
+ * ---------------------
+ * Applies a whole list of guesses in one request and answers with a JSON
+ * document holding the result of every guess.
+ *
+ * Parameters:
+ *      puzzle        - puzzle the guesses are played against
+ *      clientSocket  - socket of the requesting client
+ *      query         - query string of a GET request, or NULL
+ *      body          - start of the POST body already received, or NULL for GET
+ *      bodyReceived  - number of body bytes already received
+ *      contentLength - declared length of the POST body
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void handleBatch(struct puzzle *puzzle, int clientSocket, char *query, char *body, size_t bodyReceived, long contentLength){
+	char tooLargeMsg[100] = "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 21\r\n\r\n413 Payload Too Large";
+	char header[200];
+	char *postBody = NULL, *response;
+	char **guesses;
+	int *results;
+	int guessCount = 0, foundCount = 0;
+	size_t length = 0, size;
+	const char *resultName[] = {"wrong", "found", "already"};
+
+	if (contentLength < 0 || contentLength > MAX_BATCH_BODY){
+		send(clientSocket, tooLargeMsg, strlen(tooLargeMsg), MSG_NOSIGNAL);
+		return;
+	}
+
+	guesses = (char **)malloc(sizeof(char *) * MAX_BATCH_GUESSES);
+	results = (int *)malloc(sizeof(int) * MAX_BATCH_GUESSES);
+	if (guesses == NULL || results == NULL){
+		free(guesses);
+		free(results);
+		return;
+	}
+
+	if (query != NULL){
+		guessCount = collectGuesses(query, "move", guesses, guessCount, MAX_BATCH_GUESSES);
+	}
+	if (body != NULL && contentLength > 0){
+		postBody = readBody(clientSocket, body, bodyReceived, contentLength);
+		if (postBody != NULL){
+			guessCount = collectGuesses(postBody, "move", guesses, guessCount, MAX_BATCH_GUESSES);
+		}
+	}
+
+	unsigned long long stageStart = nowNanoseconds();
+	acceptGuesses(puzzle, guesses, guessCount, results);
+	observeLatency(&stageHistogram[STAGE_ACCEPT_INPUT], stageStart);
+
+	// Guesses are echoed whole and escaped; the buffer grows as needed
+	size = 100 + (size_t)guessCount * 64;
+	response = (char *)malloc(size);
+	for (int i = 0; i < guessCount; i++){
+		if (results[i] == GUESS_FOUND){
+			foundCount++;
+		}
+	}
+	appendText(&response, &length, &size, "{\"version\":%lu,\"found\":%d,\"done\":%s,\"results\":[",
+		atomic_load(&gameStateVersion), foundCount, isDone(puzzle) == 1 ? "true" : "false");
+	for (int i = 0; i < guessCount; i++){
+		appendText(&response, &length, &size, "%s{\"guess\":", i == 0 ? "" : ",");
+		appendJsonString(&response, &length, &size, guesses[i], strlen(guesses[i]));
+		appendText(&response, &length, &size, ",\"result\":\"%s\"}", resultName[results[i]]);
+	}
+	appendText(&response, &length, &size, "]}\n");
+	if (response != NULL){
+		snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n", length);
+		stageStart = nowNanoseconds();
+		send(clientSocket, header, strlen(header), MSG_NOSIGNAL);
+		send(clientSocket, response, length, MSG_NOSIGNAL);
+		observeLatency(&stageHistogram[STAGE_SEND], stageStart);
+		free(response);
+	}
+
+	free(postBody);
+	free(guesses);
+	free(results);
+}
+/*
+ * Function: handleHint
+ * --------------------
+ * Answers a hint request from the puzzle's hint index: how many words of the given length
+ * (length=, any length if missing) starting with the given prefix (prefix=) there are and
+ * how many of them are still hidden. With reveal=1 the first hidden one is also marked
+ * found and returned. Answers with a JSON document.
+ *
+ * Parameters:
+ *      puzzle       - puzzle the hint is for
+ *      clientSocket - socket of the requesting client
+ *      query        - query string, or NULL
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void handleHint(struct puzzle *puzzle, int clientSocket, char *query){
+	char header[200], response[200], prefix[MAX_WORD_LENGTH + 1] = "";
+	char *savePtr, *value;
+	int length = 0, reveal = 0, words = 0, hidden = 0, prefixLength = 0, isMatchable = 1;
+	struct gameListNode *revealed = NULL;
+	unsigned long long stageStart = nowNanoseconds();
+
+	if (query != NULL){
+		for (char *item = strtok_r(query, "&", &savePtr); item != NULL; item = strtok_r(NULL, "&", &savePtr)){
+			value = strchr(item, '=');
+			if (value == NULL){
+				continue;
+			}
+			*value++ = '\0';
+			if (strcmp(item, "length") == 0){
+				length = atoi(value);
+			}
+			else if (strcmp(item, "prefix") == 0){
+				// Board words are capitalized letters, a prefix with anything else cannot match
+				for (prefixLength = 0; value[prefixLength] != '\0'; prefixLength++){
+					if (!isalpha((unsigned char)value[prefixLength]) || prefixLength == MAX_WORD_LENGTH){
+						isMatchable = 0;
+						break;
+					}
+					prefix[prefixLength] = toupper((unsigned char)value[prefixLength]);
+				}
+				prefix[prefixLength] = '\0';
+			}
+			else if (strcmp(item, "reveal") == 0){
+				reveal = atoi(value) == 1;
+			}
 		}
-	} 
-	// construct HTTP response header
-	snprintf(buffer, sizeof(buffer), "HTTP/1.1 200 OK\r\nContent-Type: text/html; charset=UTF-8\r\n\r\n");
-	// Send the header and HTML_ized game content
-	send(clientSocket, buffer, strlen(buffer), 0);
-	send(clientSocket, html_buffer, strlen(html_buffer), 0);
+	}
+	if (length < 0 || length > MAX_WORD_LENGTH){
+		isMatchable = 0;
+	}
 
-	// Mark the current thread as done by setting isDone to 1
-	for (int i = 0; i < 8; i++) {
-		if (thread[i].id == currentThreadId) {
-			thread[i].isDone = 1;
-			break;
+	if (isMatchable == 1){
+		if (reveal == 1){
+			revealed = revealHint(puzzle, length, prefix);
+			if (revealed != NULL){
+				atomic_fetch_add_explicit(&hintRevealTotal, 1, memory_order_relaxed);
+			}
 		}
+		words = countHints(puzzle, length, prefix, &hidden);
 	}
-	// clean up 
-	close(clientSocket);
-	closedir(dir);
-	free(wordBuffer);
-	free(masterWordHolder);
-	free(html_buffer);
-	return NULL;
+	observeLatency(&stageHistogram[STAGE_ACCEPT_INPUT], stageStart);
+	atomic_fetch_add_explicit(&hintTotal, 1, memory_order_relaxed);
+
+	snprintf(response, sizeof(response), "{\"puzzle\":%lu,\"length\":%d,\"prefix\":\"%s\",\"words\":%d,\"hidden\":%d,"
+		"\"revealed\":%s%s%s}\n", puzzle->id, length, prefix, words, hidden, revealed ? "\"" : "", revealed ? revealed->str : "null", revealed ? "\"" : "");
+	snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-cache\r\n"
+		"Content-Length: %zu\r\n\r\n", strlen(response));
+	send(clientSocket, header, strlen(header), MSG_NOSIGNAL);
+	send(clientSocket, response, strlen(response), MSG_NOSIGNAL);
 }
-
 /*
- * Function: isThreadAvailable
- * ---------------------------
- * Checks if there is at least one available thread from a predefined array of 8 threads.
- * A thread is considered available if its 'isDone' attribute is set to 1.
+ * Function: identifyPlayer
+ * ------------------------
+ * Sets requestPlayer for the calling thread: the player= field of the query (letters, digits,
+ * '.', '-', '_' and ':' only, so it can go into JSON as is), or the client address without one.
+ *
+ * Parameters:
+ *      query - query string starting with '?', or NULL
  *
  * Return:
- *      int - Returns 1 if at least one thread is available, otherwise returns 0.
+ *      void - This function does not return a value.
  */
-int isThreadAvailable(){
-	for (int i = 0; i < 8; i++){
-		// Check if the current thread is marked as done (isDone == 1)
-		if (thread[i].isDone == 1){
-			return 1;
+void identifyPlayer(const char *query){
+	const char *value = NULL;
+	uint32_t address = workerSlot != NULL ? workerSlot->address : 0;
+	int length = 0;
+
+	for (const char *item = query; item != NULL; item = strchr(item + 1, '&')){
+		if (strncmp(item + 1, "player=", 7) == 0){
+			value = item + 8;
+			break;
 		}
 	}
-	return 0;
+	while (value != NULL && length < MAX_PLAYER_NAME - 1 && (isalnum((unsigned char)value[length]) || strchr(".-_:", value[length]) != NULL)
+			&& value[length] != '\0'){
+		requestPlayer[length] = value[length];
+		length++;
+	}
+	requestPlayer[length] = '\0';
+	if (length == 0){
+		inet_ntop(AF_INET, &address, requestPlayer, MAX_PLAYER_NAME);
+	}
 }
 /*
- * tearDown - Cleans up the game list and word list, freeing memory allocated 
+ * Function: handleLeaderboard
+ * ---------------------------
+ * Serves the leaderboard the score keeper rendered last, compressed once per render for
+ * clients that accept it. Nothing is computed here.
  *
  * Parameters:
- *  None
+ *      clientSocket - socket of the requesting client
+ *      encoding     - negotiated ENCODING_* value
  *
  * Return:
- *  void - This function does not return a value.
+ *      void - This function does not return a value.
  */
-void tearDown(){
-	cleanupGameListNode();
-	cleanupWordListNode();
-	printf("All Done\n");
+void handleLeaderboard(int clientSocket, int encoding){
+	char header[250];
+	struct renderedPage *page;
+	const char *body;
+	size_t length;
+
+	pthread_mutex_lock(&leaderboardLock);
+	page = cachedLeaderboard;
+	if (page != NULL){
+		atomic_fetch_add(&page->refCount, 1);
+	}
+	pthread_mutex_unlock(&leaderboardLock);
+	if (page == NULL){
+		body = "{\"version\":0}\n";
+		length = strlen(body);
+		encoding = ENCODING_IDENTITY;
+	}
+	else{
+		encoding = pageBody(page, encoding, &body, &length);
+	}
+	snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nCache-Control: no-cache\r\n"
+		"Vary: Accept-Encoding\r\nContent-Length: %zu\r\n%s%s%s\r\n", length,
+		encoding != ENCODING_IDENTITY ? "Content-Encoding: " : "", encoding != ENCODING_IDENTITY ? encodingName[encoding] : "",
+		encoding != ENCODING_IDENTITY ? "\r\n" : "");
+	send(clientSocket, header, strlen(header), MSG_NOSIGNAL);
+	send(clientSocket, body, length, MSG_NOSIGNAL);
+	if (page != NULL){
+		releasePage(page);
+	}
 }
 /*
- * initialization - Initializes the word list by reading words from a file
- *                   and sets up the linked list for word manipulation.
+ * Function: readBody
+ * ------------------
+ * Reads the rest of a POST body under the body deadline; part of it may already sit in the
+ * request buffer. A client that stops sending leaves a shorter body.
  *
  * Parameters:
- *  None
+ *      clientSocket  - socket of the requesting client
+ *      body          - start of the body already received
+ *      bodyReceived  - number of body bytes already received
+ *      contentLength - declared length of the body
  *
  * Return:
- *  int - The total number of words read from the file (word count).
+ *      char* - malloc'd NUL-terminated body, or NULL if an allocation failed.
  */
-int initialization(){	
-	// Generate a random seed based on the current time
-	srand(time(NULL));		
-	
-	// Hold the word position in the dictionary, initially set to 0							
-	int wordPositionInDictionary = 0;	
-	// Allocate memory for a buffer to hold a single word (max length 100 characters)		
-	char *buffer = (char*)malloc(sizeof(char) * 100);
-	// File pointer for reading the dictionary file
-	FILE *file;
-
-	// Open the "2of12.txt" file in read mode (file contains the dictionary words)
-	file = fopen("2of12.txt", "r");
-	//reading each word from the file and adding it to the linked list	
-	while (fgets(buffer, 100, file)){	
-		if (wordRoot == NULL){
-			// Remove the newline character from the word (if any)
-			buffer[strcspn(buffer, "\n\r")] = '\0';
-			wordRoot = createWordList(buffer);
-		}
-		else {
-			buffer[strcspn(buffer, "\n\r")] = '\0';
-			addWordNode(buffer, wordRoot);
-		}
-			
-		// Increment the word count
-		wordPositionInDictionary++;		
-	}
-
-	// Free the allocated memory for the buffer
-	free(buffer);
-
-	// Return the total number of words read from the file
-	return wordPositionInDictionary;
+char *readBody(int clientSocket, char *body, size_t bodyReceived, long contentLength){
+	char *postBody = (char *)malloc(contentLength + 1);
+
+	if (postBody == NULL){
+		return NULL;
+	}
+	if (bodyReceived > (size_t)contentLength){
+		bodyReceived = contentLength;
+	}
+	memcpy(postBody, body, bodyReceived);
+	armTimeout(TIMEOUT_BODY);
+	while (bodyReceived < (size_t)contentLength){
+		ssize_t got = recv(clientSocket, postBody + bodyReceived, contentLength - bodyReceived, 0);
+		if (got <= 0){
+			break;
+		}
+		bodyReceived += got;
+	}
+	armTimeout(TIMEOUT_WRITE);
+	postBody[bodyReceived] = '\0';
+	return postBody;
 }
-/**
- * gameLoop - Manages the core game loop, where the game continues until isDone return 1 
+/*
+ * Function: handleValidate
+ * ------------------------
+ * Tells which candidate words can be formed from a rack of letters, for other services.
+ * The rack is the rack= query parameter; candidates are word= parameters of the query
+ * and of a POST body (form encoded or one per line). Without candidates every word of
+ * the current dictionary the rack can form is returned. Answers with a JSON document
+ * listing the formable words and the words checked per second.
  *
  * Parameters:
- *  None
+ *      clientSocket  - socket of the requesting client
+ *      query         - query string, or NULL
+ *      body          - start of the POST body already received, or NULL for GET
+ *      bodyReceived  - number of body bytes already received
+ *      contentLength - declared length of the POST body
  *
  * Return:
- *  void - This function does not return a value.
+ *      void - This function does not return a value.
  */
-void gameLoop(int wordPositionInDictionary){
-	// Declare a pointer to store user input
-	char *userInput;
-	// Select a random word from the Word linked list to be the "master word"
-	masterWord = getRandomWord(wordRoot, wordPositionInDictionary );
-	// Find possible words related to the master word, and store them into new List call Game List
-	findWords(masterWord->str);		
-	// Set the 'found' status of all words in Game List to 'not found' in preparation for the game 
-	setAllWordsToNotFound();	
-
-	// Loop until the game is marked as done (isDone() returns 1)
-	while (isDone() != 1){
-		// Clear the terminal screen
-		system("clear");
-		// Display the master word
-		displayWord(masterWord->str);
-		// Display the current game list
-		displayGameList(gameRoot);
-		// Accept user's input (answer)
-		//userInput = acceptInput();
-		// Free the memory allocated for user input after use
-		free(userInput);
-	}
-	//check all the words 
-	displayGameList(gameRoot);
+void handleValidate(int clientSocket, char *query, char *body, size_t bodyReceived, long contentLength){
+	char tooLargeMsg[100] = "HTTP/1.1 413 Payload Too Large\r\nContent-Length: 21\r\n\r\n413 Payload Too Large";
+	char header[200];
+	char *postBody = NULL, *response, *rack = NULL, *savePtr;
+	char **words = NULL;
+	unsigned char *results = NULL;
+	int *matches = NULL;
+	int wordCount = 0, checked, formable = 0;
+	size_t length = 0, size = 4096;
+	struct dictionary *dictionary = NULL;
+	unsigned long long elapsed, stageStart;
+
+	if (contentLength < 0 || contentLength > MAX_VALIDATE_BODY){
+		send(clientSocket, tooLargeMsg, strlen(tooLargeMsg), MSG_NOSIGNAL);
+		return;
+	}
+	words = (char **)malloc(sizeof(char *) * MAX_VALIDATE_WORDS);
+	if (words == NULL){
+		return;
+	}
+
+	// The rack comes from the query, the words from both the query and the body
+	if (query != NULL){
+		for (char *item = strtok_r(query, "&", &savePtr); item != NULL; item = strtok_r(NULL, "&", &savePtr)){
+			if (strncmp(item, "rack=", 5) == 0){
+				rack = item + 5;
+			}
+			// Bare query items are not words, only word= ones are
+			else if (strncmp(item, "word=", 5) == 0 && item[5] != '\0' && wordCount < MAX_VALIDATE_WORDS){
+				words[wordCount++] = item + 5;
+			}
+		}
+	}
+	if (body != NULL && contentLength > 0){
+		postBody = readBody(clientSocket, body, bodyReceived, contentLength);
+		if (postBody != NULL){
+			wordCount = collectGuesses(postBody, "word", words, wordCount, MAX_VALIDATE_WORDS);
+		}
+	}
+	if (rack == NULL){
+		rack = "";
+	}
+	// Only letters count, everything else is dropped from the rack (and from the echo of it)
+	for (int from = 0, to = 0; ; from++){
+		if (rack[from] == '\0' || to == MAX_RACK_LENGTH){
+			rack[to] = '\0';
+			break;
+		}
+		if (isalpha((unsigned char)rack[from])){
+			rack[to++] = rack[from];
+		}
+	}
+
+	// Check the candidates, or scan the whole dictionary when there are none
+	stageStart = nowNanoseconds();
+	if (wordCount > 0){
+		results = (unsigned char *)malloc(wordCount);
+		if (results != NULL){
+			formable = validateWords(rack, (const char **)words, wordCount, results);
+		}
+		checked = wordCount;
+	}
+	else{
+		checked = 0;
+		dictionary = acquireDictionary();
+		if (dictionary != NULL){
+			matches = (int *)malloc(sizeof(int) * (dictionary->wordCount + 1));
+			if (matches != NULL){
+				formable = findFormableWords(dictionary, rack, matches);
+			}
+			checked = dictionary->wordCount;
+		}
+	}
+	elapsed = nowNanoseconds() - stageStart;
+	observeLatency(&stageHistogram[STAGE_VALIDATE], stageStart);
+	atomic_fetch_add_explicit(&wordsCheckedTotal, checked, memory_order_relaxed);
+	atomic_fetch_add_explicit(&validateNanoseconds, elapsed, memory_order_relaxed);
+
+	response = (char *)malloc(size);
+	appendText(&response, &length, &size, "{\"rack\":\"%s\",\"checked\":%d,\"formable\":%d,\"elapsed_us\":%.1f,"
+		"\"words_per_second\":%.0f,\"words\":[", rack, checked, formable, elapsed / 1e3, elapsed ? checked * 1e9 / elapsed : 0.0);
+	if (results != NULL){
+		for (int i = 0, listed = 0; i < wordCount; i++){
+			if (results[i] == 1){
+				appendText(&response, &length, &size, "%s", listed++ == 0 ? "" : ",");
+				appendJsonString(&response, &length, &size, words[i], strlen(words[i]));
+			}
+		}
+	}
+	else if (matches != NULL){
+		for (int i = 0; i < formable; i++){
+			appendText(&response, &length, &size, "%s", i == 0 ? "" : ",");
+			appendJsonString(&response, &length, &size, dictionaryWord(dictionary, matches[i]), dictionary->length[matches[i]]);
+		}
+	}
+	appendText(&response, &length, &size, "]}\n");
+	if (response != NULL){
+		snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n\r\n", length);
+		stageStart = nowNanoseconds();
+		send(clientSocket, header, strlen(header), MSG_NOSIGNAL);
+		send(clientSocket, response, length, MSG_NOSIGNAL);
+		observeLatency(&stageHistogram[STAGE_SEND], stageStart);
+		free(response);
+	}
+
+	if (dictionary != NULL){
+		releaseDictionary(dictionary);
+	}
+	free(matches);
+	free(results);
+	free(postBody);
+	free(words);
 }
 /*
- * Function: acceptInput
+ * Function: sseSubscribe
  * ----------------------
- * Processes user input, converts to uppercase, and checks for matches in the game list.
+ * Answers a GET /events request with a Server-Sent Events header and registers the
+ * client socket as a subscriber. From then on the socket belongs to the broadcaster.
  *
  * Parameters:
- *      input - User input string.
+ *      clientSocket - socket of the client asking for the event stream
  *
  * Return:
- *      char* - Processed user input.
+ *      int - Returns 0 if the client is subscribed, or -1 if an error occurs.
  */
-char *acceptInput(char *input){
-	// Temporary pointer to traverse the game list
-	struct gameListNode *temp = gameRoot;
-	// Allocate memory for the user's input (maximum of 100 characters)
-	//char *input = (char *)malloc(sizeof(char) * 100);
-	// Prompt the user for a guess
-	//printf("Enter a guess: ");
-	// Read user input from stdin (up to 100 characters)
-	//fgets(input, 100, stdin);			
-	// Remove newline characters from the input string		
-	input[strcspn(input, "\r\n")] = '\0';		
-	// Convert all characters in the input to uppercase		
-	for (int i = 0; i < strlen(input); i++){			
-		input[i] = toupper(input[i]);				
-	}
-	// Print the processed user input
-	printf("The User Input is: %s\n", input);
-	// Check if the input is the cheat code ("110")
-	if (strcmp(input, "110") == 0){
-		cheat();
-	}
-	// Traverse the game list and mark words as found if the user's input matches any word
-	while(temp){
-		if (strcmp(input, temp->str) == 0){
-			temp->isFound = 1;
-		}
-		temp = temp->next;
-	}
-	// Return the processed input
-	return input;
+int sseSubscribe(int clientSocket){
+	const char *header = "HTTP/1.1 200 OK\r\n"
+		"Content-Type: text/event-stream\r\n"
+		"Cache-Control: no-cache\r\n"
+		"Connection: keep-alive\r\n"
+		"\r\n"
+		"retry: 3000\n\n";
+
+	if (send(clientSocket, header, strlen(header), MSG_NOSIGNAL) != (ssize_t)strlen(header)){
+		return -1;
+	}
+
+	pthread_mutex_lock(&sseSubscriberLock);
+	// Grow the subscriber array when it is full
+	if (sseSubscriberCount == sseSubscriberCapacity){
+		int newCapacity = sseSubscriberCapacity == 0 ? 64 : sseSubscriberCapacity * 2;
+		int *grown = (int *)realloc(sseSubscriber, sizeof(int) * newCapacity);
+		if (grown == NULL){
+			pthread_mutex_unlock(&sseSubscriberLock);
+			return -1;
+		}
+		sseSubscriber = grown;
+		sseSubscriberCapacity = newCapacity;
+	}
+	sseSubscriber[sseSubscriberCount++] = clientSocket;
+	pthread_mutex_unlock(&sseSubscriberLock);
+	return 0;
 }
 /*
- * displayWord - Displays the letters of the master word in uppercase and sorted order.
+ * Function: publishEvent
+ * ----------------------
+ * Serializes one Server-Sent Event and queues it for the broadcaster. The event is
+ * formatted exactly once; the same buffer is then written to every subscriber.
  *
  * Parameters:
- *  char *masterWordStr - The string representing the master word.
+ *      eventName - SSE event type (e.g. "found", "puzzle")
+ *      data      - single line payload of the event
  *
  * Return:
- *  *char - formated master word string
+ *      void - This function does not return a value.
  */
-char *displayWord(char *masterWordStr){
-	// Print a separator
-//	printf("\n-----------------------------------------------------------------------------------\n");
-
-	// Get the length of the master word string
-    	int length = strlen(masterWordStr);
-    
-    	// Create a char array to store the letters of the word
-    	char *word = (char *)malloc(sizeof(char) * length);
-	memset(word, 0, sizeof(char) * (length + 1));
-	char letter;
-
-	// Loop through each character of the word and process it
-	for (int i = 0; i < length; i++){
-		// Store the current character in the letter variable
-		letter = masterWordStr[i];
-
-		// Only process alphabetic characters
-		if (isalpha(letter)){ 		
-			// Convert the letter to uppercase and store it in the word array
-			word[i] = toupper(letter);	
-		}
-	}
-
-	// Sort the array of letters
-	/*
-	 * Compare each letter to every letter with a greater index.
-	 * If the current letter is smaller, swap their positions.
-	 */
-	for (int i = 0; i < length; i++){
-		for (int j = 1; i + j < length; j++){
-			if (word[i] <= word[i + j]){
-				// Swap the letters
-				letter = word[i];
-				word[i] = word[i + j];
-				word[i + j] = letter;
-			}
-		}
+void publishEvent(const char *eventName, const char *data){
+	struct sseEvent *event = (struct sseEvent *)malloc(sizeof(struct sseEvent));
+	if (event == NULL){
+		return;
 	}
-
-	// Print the sorted list of letters
-	for (int i = 0; i < length; i++){
-		printf("%c\t", word[i]);
+	size_t size = strlen(eventName) + strlen(data) + 20;
+	event->data = (char *)malloc(size);
+	if (event->data == NULL){
+		free(event);
+		return;
 	}
+	event->length = snprintf(event->data, size, "event: %s\ndata: %s\n\n", eventName, data);
+	event->next = NULL;
 
-	// Print a separator
-//	printf("\n-----------------------------------------------------------------------------------\n");
-	return word;
+	// Append to the queue and wake the broadcaster
+	pthread_mutex_lock(&sseQueueLock);
+	if (sseQueueTail == NULL){
+		sseQueueHead = event;
+	}
+	else{
+		sseQueueTail->next = event;
+	}
+	sseQueueTail = event;
+	pthread_cond_signal(&sseQueueCond);
+	pthread_mutex_unlock(&sseQueueLock);
+}
+/*
+ * Function: publishWordFound
+ * --------------------------
+ * Publishes a "found" event for a word that was just guessed.
+ *
+ * Parameters:
+ *      word - the word that has been found
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void publishWordFound(char *word){
+	char data[100];
+	snprintf(data, sizeof(data), "{\"word\":\"%s\",\"version\":%lu}",
+		word, atomic_load(&gameStateVersion));
+	publishEvent("found", data);
 }
 /*
- * isDone - Checks if all the words in the game list have been found.
+ * Function: publishNewPuzzle
+ * --------------------------
+ * Publishes a "puzzle" event carrying the letters and word count of the new board.
  *
  * Parameters:
- *  None
+ *      puzzle - the puzzle that has just been swapped in
  *
  * Return:
- *  int - Returns 1 if all words have been found, otherwise returns 0 to continue the game.
+ *      void - This function does not return a value.
  */
-int isDone(){	
-	// Temporary pointer to traverse the game list
-	struct gameListNode *temp = gameRoot;
-
-	// Variable to track if any word in the game list is not found
-	int switchHolder = 0;
-
-	// Traverse through the game list nodes
-	while(temp){
-		// If any word is not found, set switchHolder to 1
-		if (temp->isFound == 0){
-			switchHolder = 1;
-		}
-		temp = temp->next;
-	}
-
-	// If switchHolder is 1, it means not all words are found, so return 0
-	if (switchHolder == 1){
-		return 0;
+void publishNewPuzzle(struct puzzle *puzzle){
+	char data[200];
+	char *letters = displayWord(puzzle->masterWord);
+	if (letters == NULL){
+		return;
 	}
-
-	// If all words are found, return 1 to indicate the game is done
-	return 1;
+	snprintf(data, sizeof(data), "{\"puzzle\":%lu,\"letters\":\"%s\",\"words\":%d,\"version\":%lu}",
+		puzzle->id, letters, puzzle->wordCount, atomic_load(&gameStateVersion));
+	free(letters);
+	publishEvent("puzzle", data);
 }
 /*
- * getLetterDistribution - Calculates the frequency of each letter in the input string.
+ * Function: sseBroadcaster
+ * ------------------------
+ * Background thread that drains the event queue and fans every event out to all
+ * subscribers. Sends never block: a subscriber that cannot take a whole event right
+ * away (slow or gone) is dropped. Idle streams get a keepalive comment so dead
+ * peers are noticed.
  *
  * Parameters:
- *  char *strInput - The input string for which to count letter occurrences.
+ *      value - unused
  *
  * Return:
- *  int* - An array of 26 integers representing the count of each letter (A-Z) in the input string.
+ *      void* - Never returns.
  */
-int *getLetterDistribution(char *strInput){
-	// Allocate memory for an array of 26 integers (one for each letter of the alphabet)
-	int *letterCounter = (int *)malloc(sizeof(int) * 26);
+void *sseBroadcaster(void *value){
+	static const char keepalive[] = ": keepalive\n\n";
+	struct sseEvent *event;
+	struct timespec deadline;
+	const char *data;
+	size_t length;
+
+	while (1){
+		// Wait for the next event, or for the keepalive interval to pass
+		pthread_mutex_lock(&sseQueueLock);
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		deadline.tv_sec += SSE_KEEPALIVE;
+		while (sseQueueHead == NULL){
+			if (pthread_cond_timedwait(&sseQueueCond, &sseQueueLock, &deadline) == ETIMEDOUT){
+				break;
+			}
+		}
+		event = sseQueueHead;
+		if (event != NULL){
+			sseQueueHead = event->next;
+			if (sseQueueHead == NULL){
+				sseQueueTail = NULL;
+			}
+		}
+		pthread_mutex_unlock(&sseQueueLock);
 
-	//init the array to 0
-	memset(letterCounter, 0, sizeof(int) * 26);
+		data = event ? event->data : keepalive;
+		length = event ? event->length : strlen(keepalive);
 
-	// Loop over the input string to count the occurrences of each letter
-	for (int i = 0; i < strlen(strInput); i++){				
-		// If the character is a lowercase letter (a-z)
-		if (strInput[i] >= 'a' && strInput[i] <= 'z'){		
-			// Increment the corresponding array index for this letter
-			letterCounter[(int)strInput[i] - 97] += 1;		
+		// Fan the shared buffer out, dropping subscribers that cannot keep up
+		pthread_mutex_lock(&sseSubscriberLock);
+		for (int i = 0; i < sseSubscriberCount; ){
+			if (send(sseSubscriber[i], data, length, MSG_DONTWAIT | MSG_NOSIGNAL) != (ssize_t)length){
+				close(sseSubscriber[i]);
+				sseSubscriber[i] = sseSubscriber[--sseSubscriberCount];
+			}
+			else{
+				i++;
+			}
 		}
-		// If the character is an uppercase letter (A-Z)
-		else if (strInput[i] >= 'A' && strInput[i] <= 'Z'){	
-			// Increment the corresponding array index for this letter
-			letterCounter[(int)strInput[i] - 65] += 1;		
+		pthread_mutex_unlock(&sseSubscriberLock);
+
+		if (event != NULL){
+			free(event->data);
+			free(event);
 		}
 	}
-
-	// Return the array containing letter counts
-	return letterCounter;
+	return NULL;
 }
-/**
- * compareCounts - Compares the letter counts of the master word and the words in the dictionary.
+/*
+ * Function: isThreadAvailable
+ * ---------------------------
+ * Checks if there is at least one available thread among the 8 worker slots of a listener.
+ * A thread is considered available if its 'isDone' attribute is set to 1.
  *
  * Parameters:
- *  int *choiceCount - Array representing the letter counts of the master word.
- *  int *userInputCount - Array representing the letter counts of the dictionary word.
+ *      owner - listener whose worker slots are checked
  *
  * Return:
- *  int - Returns 1 (true) if the word in the dictionary can be formed from the master word letters, otherwise returns 0 (false).
+ *      int - Returns 1 if at least one thread is available, otherwise returns 0.
  */
-int compareCounts(int *choiceCount, int *userInputCount){
-	// Loop through the letter counts (for each letter A-Z)
-	for (int i = 0; i < 26; i++){
-		// If the master word has fewer occurrences of a letter than the user's input
-		if (choiceCount[i] < userInputCount[i]){			
-			// Return 0 (false) as the input cannot be made from the master word
-			return 0;						
+int isThreadAvailable(struct listener *owner){
+	for (int i = 0; i < WORKERS_PER_LISTENER; i++){
+		// Check if the current thread is marked as done (isDone == 1)
+		if (owner->thread[i].isDone == 1){
+			return 1;
 		}
 	}
-	// If all conditions are met, return 1 (true)
-	return 1;
+	return 0;
 }
 /*
- * wordListCreate - Creates the root node for the word linked list.
+ * tearDown - Cleans up the game list and word list, freeing memory allocated 
  *
  * Parameters:
- *  char *word - The word to store in the linked list node.
+ *  None
  *
  * Return:
- *  struct wordListNode* - Returns a pointer to the newly created word list node.
+ *  void - This function does not return a value.
  */
-struct wordListNode *createWordList(char *word){
-	// Dynamically allocate memory for a new word list node
-	struct wordListNode *root = (struct wordListNode*)malloc(sizeof(struct wordListNode));		
-
-	// Copy the provided word into the node's 'str' field
-	strcpy(root->str, word);								
-
-	// Set the 'next' pointer to NULL, as this is the root node
-	root->next = NULL;										
-
-	// Return the newly created node
-	return root;
+void tearDown(){
+	releasePuzzle(currentPuzzle);
+	if (nextPuzzle != NULL){
+		releasePuzzle(nextPuzzle);
+	}
+	if (cachedPage != NULL){
+		releasePage(cachedPage);
+	}
+	cleanupDictionary();
+	printf("All Done\n");
 }
 /*
- * addWordNode - Adds a new word node to the linked list after the last node.
+ * acquirePuzzle - Takes a reference on the puzzle currently being played, after catching up
+ *                 with the shared game when there is one.
  *
  * Parameters:
- *  char *word - The word to add to the new node.
- *  struct wordListNode *root - The root node of the linked list.
+ *  None
  *
  * Return:
- *  void - This function does not return a value.
+ *  struct puzzle* - The current puzzle; hand it back with releasePuzzle.
  */
-void addWordNode(char *word, struct wordListNode *root){
-	// Check if the root node exists
-	if (root == NULL){										
-		printf("Error: root does not exist\n\n");
-		return;
-	}
+struct puzzle *acquirePuzzle(){
+	struct puzzle *puzzle;
 
-	// Create a new node to attach to the end of the list
-	struct wordListNode *newNode = createWordList(word);			
-
-	// Check if the new node was successfully created
-	if (newNode == NULL){
-		printf("newNode Created fail");
-	}
-
-	// Traverse the list to find the last node
-	while (root->next != NULL){								
-		root = root->next;
+	if (sharedGame != NULL){
+		syncSharedGame();
 	}
-
-	// Attach the new node to the end of the list
-	root->next = newNode;									
+	pthread_mutex_lock(&puzzleLock);
+	puzzle = currentPuzzle;
+	atomic_fetch_add(&puzzle->refCount, 1);
+	pthread_mutex_unlock(&puzzleLock);
+	return puzzle;
 }
 /*
- * displayWordList - Displays all the words in the word linked list.
+ * wordsFound - Engine hook run after a guess, a batch, a hint or the cheat code newly
+ *              found words: bumps the state version once, notifies subscribers, scores
+ *              guessed words and rolls the puzzle over if that completed the board. With
+ *              a shared game the words are recorded in the segment and the version is
+ *              the shared one.
  *
  * Parameters:
- *  struct wordListNode *root - The root node of the word list.
+ *  struct puzzle *puzzle - The puzzle the words belong to.
+ *  struct gameListNode **words - The newly found words.
+ *  int count - Number of newly found words.
+ *  int isGuessed - 1 if a guess matched them, 0 if a hint or the cheat code revealed them.
  *
  * Return:
  *  void - This function does not return a value.
  */
-void displayWordList(struct wordListNode *root){
-    // Temporary pointer to traverse the list
-    struct wordListNode *temp = root;
-    
-    // Loop through each node in the linked list and print the word
-    while(temp != NULL){
-        printf("%s\n", temp->str);
-        temp = temp->next;
-    }
+void wordsFound(struct puzzle *puzzle, struct gameListNode **words, int count, int isGuessed){
+	int isCompleted;
+
+	// Whoever finds the last word completes the board, in the segment or on the local puzzle
+	if (sharedGame != NULL){
+		shareFoundWords(sharedGame, puzzle, words, count, &isCompleted);
+		syncSharedGame();
+	}
+	else{
+		atomic_fetch_add(&gameStateVersion, 1);
+		isCompleted = isDone(puzzle) == 1 && atomic_exchange(&puzzle->isCompleted, 1) == 0;
+	}
+	// Revealed words earn nothing, and a board they finish records no completion
+	if (isGuessed == 1){
+		scoreWords(puzzle, words, count, isCompleted);
+	}
+	for (int i = 0; i < count; i++){
+		publishWordFound(words[i]->str);
+	}
+	if (sharedGame != NULL ? isSharedPuzzleDone(sharedGame, puzzle->id) : isDone(puzzle) == 1){
+		tryRollover();
+	}
 }
-/**
- * getRandomWord - Selects a random word from the linked list of words.
+/*
+ * tryRollover - Swaps the prepared puzzle in if the current one is complete.
+ *               Called by the completing guess and by the builder once a puzzle
+ *               is ready, so whichever happens last performs the swap.
+ *               With a shared game the prepared puzzle is dealt to the segment; only
+ *               the first process to get there swaps, the others take its board up.
  *
  * Parameters:
- *  struct wordListNode *root - The root node of the word list.
- *  int totalWordCount - The total number of words in the dictionary.
+ *  None
  *
  * Return:
- *  struct wordListNode* - Returns a pointer to the randomly selected word node.
+ *  void - This function does not return a value.
  */
-struct wordListNode *getRandomWord(struct wordListNode* root, int totalWordCount){
-	// Check if the function has failed too many times to find a suitable word
-	if (findBugHelper > 10){
-		printf("There may not be a word larger than 6\n");
-		exit(EXIT_FAILURE);
+void tryRollover(){
+	struct puzzle *finished = NULL, *started = NULL, *oversized = NULL;
+	int isDealt = 0;
+
+	pthread_mutex_lock(&puzzleLock);
+	if (sharedGame != NULL && nextPuzzle != NULL){
+		isDealt = dealSharedPuzzle(sharedGame, nextPuzzle, currentPuzzle->id);
+		if (isDealt == -1){
+			// Too large for the segment, build another
+			oversized = nextPuzzle;
+			nextPuzzle = NULL;
+			pthread_cond_signal(&puzzleBuilderCond);
+		}
 	}
-
-	// Seed the random number generator and generate a random number that are not exceeded total number of words in dictionary 
-	srand(time(NULL));
-	int randomNum = (rand() % totalWordCount) + 1;
-
-	// Initialize a counter to track word positions in the list
-	int counter = 1;									
-
-	// Temporary pointer to traverse the list
-	struct wordListNode *temp = root;			
-
-	// Holder for ensuring we don't get a word that is too short
-	struct wordListNode *holder = temp;					
-
-	// Traverse the list to reach the randomly selected word position
-	while (counter != randomNum){							
-		temp = temp->next;
-		counter++;										
+	if ((sharedGame != NULL ? isDealt == 1 : isDone(currentPuzzle) == 1) && nextPuzzle != NULL){
+		finished = currentPuzzle;
+		started = nextPuzzle;
+		started->startedAt = nowNanoseconds();
+		currentPuzzle = nextPuzzle;
+		nextPuzzle = NULL;
+		// let the builder start on the one after
+		pthread_cond_signal(&puzzleBuilderCond);
+	}
+	pthread_mutex_unlock(&puzzleLock);
+	if (oversized != NULL){
+		LOG(LOG_WARN, "event=shared_deal_skipped puzzle=%lu words=%d", oversized->id, oversized->wordCount);
+		releasePuzzle(oversized);
 	}
 
-	// Search for a word long enough (greater than 6 characters)
-	while (temp != NULL){
-		// If the word is too short, continue to the next node
-		if (strlen(temp->str) <= 6){
-			printf("%s\n", temp->str);
-			temp = temp->next;
-			counter++;
+	if (started != NULL){
+		//let every subscriber know a new board is up
+		if (sharedGame != NULL){
+			syncSharedGame();
 		}
 		else{
-			// Print information about the random number and the current counter for Testing 
-			//printf("Random Number: %d\n", randomNum);
-			//printf("counter Number: %d\n", counter);
-
-			// Remove any carriage returns or line feeds from the word
-			temp->str[strcspn(temp->str, "\r\n")] = '\0';				
-			return temp;
+			atomic_fetch_add(&gameStateVersion, 1);
 		}
-
-		// Handle the case where we reach the end of the dictionary without finding a suitable word
-		if (counter == totalWordCount && strlen(temp->str) <= 6){
-			findBugHelper++;
-			temp = wordRoot;
-			temp = getRandomWord(temp, totalWordCount);	// Recursively call this function again
-			break;
-		}	       
+		atomic_fetch_add_explicit(&rolloverTotal, 1, memory_order_relaxed);
+		publishNewPuzzle(started);
+		releasePuzzle(finished);
 	}
-
-	// Reset findBugHelper if the function successfully finds a suitable word
-	findBugHelper = 0;
-
-	// Strip off carriage returns and line feeds from the selected word
-	temp->str[strcspn(temp->str, "\r\n")] = '\0';				
-
-	// Return the selected word
-	return temp;
 }
-/**
- * createGameList - Creates a root node for the game list.
+/*
+ * syncSharedGame - Brings this process' copy of the shared game up to date: takes up a board
+ *                  another process dealt, or marks the words other processes found. The state
+ *                  version follows the shared one, only once the change is applied, so a page
+ *                  or ETag never claims a version it does not show. Subscribers are told what
+ *                  changed, and a shared board completed elsewhere is rolled over from here too.
  *
  * Parameters:
- *  char *word - The word to store in the game list root node.
+ *  None
  *
  * Return:
- *  struct gameListNode* - Returns a pointer to the newly created game list root node.
+ *  void - This function does not return a value.
  */
-struct gameListNode *createGameList(char *word){			
-	// Remove the newline character from the word
-	word[strcspn(word, "\n")] = '\0';
-
-	// Dynamically allocate memory for the new game list node
-	struct gameListNode *root = (struct gameListNode*)malloc(sizeof(struct gameListNode));
-
-	// Copy the word into the node's string field
-	strcpy(root->str, word);
-
-	// Set the next pointer to NULL since it's the root node
-	root->next = NULL;
+void syncSharedGame(){
+	struct puzzle *puzzle, *adopted = NULL, *finished = NULL;
+	struct gameListNode **newlyFound = NULL;
+	unsigned long version, sharedId;
+	int count = 0, isFinished;
+
+	// Nothing changed since the last sync: one load from the segment
+	version = atomic_load(&sharedGame->stateVersion);
+	if (version <= atomic_load(&gameStateVersion)){
+		return;
+	}
+	pthread_mutex_lock(&sharedSyncLock);
+	version = atomic_load(&sharedGame->stateVersion);
+	if (version <= atomic_load(&gameStateVersion)){
+		pthread_mutex_unlock(&sharedSyncLock);
+		return;
+	}
+	pthread_mutex_lock(&puzzleLock);
+	puzzle = currentPuzzle;
+	atomic_fetch_add(&puzzle->refCount, 1);
+	pthread_mutex_unlock(&puzzleLock);
+
+	sharedId = atomic_load(&sharedGame->puzzleId);
+	if (sharedId != 0 && sharedId != puzzle->id){
+		adopted = adoptSharedPuzzle(sharedGame);
+		if (adopted == NULL){
+			// Still being dealt, the next sync takes it up
+			pthread_mutex_unlock(&sharedSyncLock);
+			releasePuzzle(puzzle);
+			return;
+		}
+		adopted->startedAt = nowNanoseconds();
+		pthread_mutex_lock(&puzzleLock);
+		finished = currentPuzzle;
+		currentPuzzle = adopted;
+		pthread_mutex_unlock(&puzzleLock);
+	}
+	else if (sharedId != 0){
+		newlyFound = (struct gameListNode **)malloc(sizeof(struct gameListNode *) * puzzle->wordCount);
+		if (newlyFound != NULL){
+			count = pullFoundWords(sharedGame, puzzle, newlyFound);
+		}
+	}
+	atomic_store(&gameStateVersion, version);
+	pthread_mutex_unlock(&sharedSyncLock);
+	atomic_fetch_add_explicit(&sharedSyncTotal, 1, memory_order_relaxed);
 
-	// Return the newly created root node
-	return root;
+	for (int i = 0; i < count; i++){
+		publishWordFound(newlyFound[i]->str);
+	}
+	free(newlyFound);
+	if (adopted != NULL){
+		publishNewPuzzle(adopted);
+		releasePuzzle(finished);
+	}
+	// The board is complete (or was dropped by a process that died dealing): deal the next one
+	isFinished = sharedId == 0 || (adopted == NULL && isSharedPuzzleDone(sharedGame, puzzle->id) == 1);
+	releasePuzzle(puzzle);
+	if (isFinished == 1){
+		tryRollover();
+	}
 }
-/**
- * addGameListNode - Adds a new node to the game list after the last node.
+/*
+ * scoreWords - Credits words a guess newly found to the player of the current request,
+ *              and the completion to the guess that found the board's last word (decided
+ *              by wordsFound; for a shared game in the segment, so one process credits it).
+ *              Two counter adds and one queue slot each: the totals and leaderboards are
+ *              the score keeper's.
  *
  * Parameters:
- *  char *word - The word to store in the new game list node.
- *  struct gameListNode *root - The root node of the game list.
+ *  struct puzzle *puzzle - The puzzle the words belong to.
+ *  struct gameListNode **words - The newly found words.
+ *  int count - Number of newly found words.
+ *  int isCompleted - 1 if these words completed the board.
  *
  * Return:
  *  void - This function does not return a value.
  */
-void addGameListNode(char *word, struct gameListNode *root){
-	// Remove the newline character from the word
-	word[strcspn(word, "\n")] = '\0';
+void scoreWords(struct puzzle *puzzle, struct gameListNode **words, int count, int isCompleted){
+	struct scoreEvent event;
 
-	// Check if the root node exists
-	if (root == NULL){
-		printf("Error: root does not exist\n\n");
+	if (requestPlayer[0] == '\0'){
 		return;
 	}
-
-	// Create a new game list node to add to the list
-	struct gameListNode *newNode = createGameList(word);
-
-	// Check if the new node was successfully created
-	if (newNode == NULL){
-		printf("Game newNode Created fail");
+	event.kind = SCORE_WORDS;
+	event.words = count;
+	event.points = 0;
+	for (int i = 0; i < count; i++){
+		event.points += strlen(words[i]->str);
 	}
-
-	// Traverse the list to find the last node
-	while (root->next != NULL){
-		root = root->next;
+	event.puzzleId = puzzle->id;
+	event.elapsed = 0;
+	memcpy(event.player, requestPlayer, MAX_PLAYER_NAME);
+	recordScore(&event);
+	if (isCompleted == 1){
+		event.kind = SCORE_COMPLETION;
+		event.elapsed = nowNanoseconds() - puzzle->startedAt;
+		recordScore(&event);
 	}
-
-	// Attach the new node to the end of the list
-	root->next = newNode;
 }
-/**
- * findWords - Finds and creates a game list of words from the dictionary that can be formed using the letters of the master word.
+/*
+ * scoreKeeper - Background thread applying the queued score events every
+ *               SCORE_INTERVAL_MS and rendering the leaderboard once per batch,
+ *               so /leaderboard requests only ever copy out the cached render.
  *
  * Parameters:
- *  char *masterWord - The master word whose letters are used to form other words from the dictionary.
+ *  void *value - Unused.
  *
  * Return:
- *  struct gameListNode* - Returns the root of the game list, which contains words formed from the master word.
+ *  void* - Never returns.
  */
-struct gameListNode *findWords(char *masterWord){
-	// Temporary pointer to traverse the word list (dictionary)
-	struct wordListNode *temp = wordRoot;
-
-	// Check if the word root (dictionary) exists
-	if (temp == NULL){
-		printf("wordRoot error\n\n");
-		return NULL;
-	}
-
-	// Integer pointers to hold the letter distributions for the master word and the current dictionary word
-	int *masterWordArray, *dictionaryWordArray;
-
-	// Get the letter distribution for the master word
-	masterWordArray = getLetterDistribution(masterWord);
-
-	// Loop over each word in the dictionary linked list
-	while (temp){
-		// Get the letter distribution for the current dictionary word
-		dictionaryWordArray = getLetterDistribution(temp->str);
+void *scoreKeeper(void *value){
+	struct renderedPage *page, *replaced;
+	char *json;
+	size_t length;
 
-		// Check if the current dictionary word can be formed using the letters of the master word
-		if (compareCounts(masterWordArray, dictionaryWordArray) == 1){
-			// If the game list root doesn't exist, create the first node with the current dictionary word
-			if (gameRoot == NULL){
-				gameRoot = createGameList(temp->str);
-			}
-			// Otherwise, add the current dictionary word to the end of the game list
-			else{
-				addGameListNode(temp->str, gameRoot);
-			}
+	while (1){
+		if (applyScoreEvents() == 0){
+			usleep(SCORE_INTERVAL_MS * 1000);
+			continue;
+		}
+		json = renderLeaderboard(&length);
+		page = (struct renderedPage *)calloc(1, sizeof(struct renderedPage));
+		if (json == NULL || page == NULL){
+			free(json);
+			free(page);
+			continue;
+		}
+		page->body[ENCODING_IDENTITY] = json;
+		page->length[ENCODING_IDENTITY] = length;
+		pthread_mutex_init(&page->lock, NULL);
+		atomic_init(&page->refCount, 1);
+		pthread_mutex_lock(&leaderboardLock);
+		replaced = cachedLeaderboard;
+		cachedLeaderboard = page;
+		pthread_mutex_unlock(&leaderboardLock);
+		if (replaced != NULL){
+			releasePage(replaced);
 		}
-
-		// Move to the next word in the dictionary
-		temp = temp->next;
-
-		// Free the memory allocated for the dictionary word's letter distribution
-		free(dictionaryWordArray);
 	}
-
-	// Free the memory allocated for the master word's letter distribution
-	free(masterWordArray);
-
-	// Return the root of the game list containing words formed from the master word
-	return gameRoot;
+	return NULL;
 }
 /*
- * Function: displayGameList
- * --------------------------
- * Displays words in the game list, showing dashes for unfound words and printing found words.
+ * sharedGameFollower - Background thread syncing with the shared game every
+ *                      SHARED_SYNC_INTERVAL_MS, so subscribers of this process hear
+ *                      about other processes' moves while no request comes in.
  *
  * Parameters:
- *      root - Root node of the game list.
+ *  void *value - Unused.
  *
  * Return:
- *      char* - HTML representation of the game list.
+ *  void* - Never returns.
  */
-char *displayGameList(struct gameListNode *root){
-	char gameContent[BUFFER_SIZE * 10];
-	memset(gameContent, 0, sizeof(gameContent));
-
-	// Variable to hold the length of each word
-	int wordLength;
-
-	// Capitalize the words stored in the game list
-	capitalizedWordInGameList(root);
-
-	// Check if the root of the game list exists
-	if (root == NULL){
-		printf("Game List is Empty\n\n");
-	}
-
-	// Temporary pointer to traverse the game list
-	struct gameListNode *temp = gameRoot;
-
-	strcat(gameContent, "<div class=\"container\">");
-	// Traverse the game list and display each word
-	while (temp){
-		// If the word has not been found, print dashes in place of the letters
-		if (temp->isFound == 0){
-			strcat(gameContent, "<p>");
-			wordLength = strlen(temp->str);		
-			for (int i = 0; i < wordLength; i++){
-				strcat(gameContent, "_ ");	
-				//printf("-  ");
-			}
-			strcat(gameContent, "</p>\n");
-			//printf("\n");
-			temp = temp->next;
-		}
-		// If the word has been found, print the word (html_ized game content)
-		else{
-			strcat(gameContent, "<p>");
-			strcat(gameContent, "Found:");
-			strcat(gameContent, temp->str);
-			strcat(gameContent, "</p>\n");
-			//printf("FOUND: %s\n", temp->str);
-			temp = temp->next;
-		}
+void *sharedGameFollower(void *value){
+	while (1){
+		usleep(SHARED_SYNC_INTERVAL_MS * 1000);
+		syncSharedGame();
 	}
-	strcat(gameContent, "</div>");
-
-	char *buffer = (char *)malloc(sizeof(char) * (strlen(gameContent) + 1));
-	memset(buffer, 0, sizeof(char) * (strlen(gameContent) + 1));
-	strcpy(buffer, gameContent);
-	return buffer;
+	return NULL;
 }
 /*
- * capitalizedWordInGameList - Converts all words in the game list to uppercase.
+ * puzzleBuilder - Background thread keeping the next puzzle ready, so no request
+ *                 ever pays for getRandomWord and findWords.
  *
  * Parameters:
- *  struct gameListNode *root - The root node of the game list.
+ *  void *value - Unused.
  *
  * Return:
- *  void - This function does not return a value.
+ *  void* - Never returns.
  */
-void capitalizedWordInGameList(struct gameListNode *root){
-	// Traverse each node in the game list
-	while (root){
-		// Convert each character of the word to uppercase
-		for (int i = 0; i < strlen(root->str); i++){
-			(root->str)[i] = toupper((root->str)[i]);
+void *puzzleBuilder(void *value){
+	struct puzzle *puzzle;
 
-			// Strip off carriage returns and line feeds from the word
-			root->str[strcspn(root->str, "\r\n")] = '\0';				
+	while (1){
+		// Sleep until the prepared puzzle has been used
+		pthread_mutex_lock(&puzzleLock);
+		while (nextPuzzle != NULL){
+			pthread_cond_wait(&puzzleBuilderCond, &puzzleLock);
+		}
+		pthread_mutex_unlock(&puzzleLock);
+
+		puzzle = buildPuzzle();
+		if (puzzle == NULL){
+			sleep(1);
+			continue;
 		}
+		pthread_mutex_lock(&puzzleLock);
+		nextPuzzle = puzzle;
+		pthread_mutex_unlock(&puzzleLock);
 
-		// Move to the next node in the list
-		root = root->next;
+		// The board may have been finished while nothing was ready yet
+		tryRollover();
 	}
+	return NULL;
 }
 /*
- * cheat - Marks all words in the game list as found.
+ * dictionaryReloader - Background thread waiting for SIGHUP. Loads and indexes the word list
+ *                      off every request path, swaps it in, then drops the prepared puzzle
+ *                      so the next board already comes from the new list. The board being
+ *                      played is left alone.
  *
  * Parameters:
- *  None
+ *  void *value - Unused.
  *
  * Return:
- *  void - This function does not return a value.
+ *  void* - Never returns.
  */
-void cheat(){
-	// Temporary pointer to traverse the game list
-	struct gameListNode *temp = gameRoot;
+void *dictionaryReloader(void *value){
+	struct puzzle *stale;
+	int signalNumber;
 
-	// Mark all words as found
-	while (temp){
-		temp->isFound = 1;
-		temp = temp->next;
+	while (1){
+		if (sigwait(&reloadSignals, &signalNumber) != 0){
+			continue;
+		}
+		LOG(LOG_INFO, "event=dictionary_reload_requested signal=%d", signalNumber);
+		if (reloadDictionary() == 0){
+			atomic_fetch_add_explicit(&dictionaryReloadFailedTotal, 1, memory_order_relaxed);
+			continue;
+		}
+		atomic_fetch_add_explicit(&dictionaryReloadTotal, 1, memory_order_relaxed);
+
+		pthread_mutex_lock(&puzzleLock);
+		stale = nextPuzzle;
+		nextPuzzle = NULL;
+		pthread_cond_signal(&puzzleBuilderCond);
+		pthread_mutex_unlock(&puzzleLock);
+		if (stale != NULL){
+			releasePuzzle(stale);
+		}
 	}
+	return NULL;
 }
-/**
- * setAllWordsToNotFound - Marks all words in the game list as not found.
+/*
+ * snapshotWriter - Background thread keeping the snapshot at snapshotPath current: every
+ *                  SNAPSHOT_INTERVAL seconds it is rewritten if the game state moved on.
+ *                  On SIGTERM or SIGINT it writes a last one and ends the process.
  *
  * Parameters:
- *  None
+ *  void *value - Unused.
  *
  * Return:
- *  void - This function does not return a value.
+ *  void* - Never returns.
  */
-void setAllWordsToNotFound(){
-	// Temporary pointer to traverse the game list
-	struct gameListNode *temp = gameRoot;
+void *snapshotWriter(void *value){
+	struct timespec interval = {SNAPSHOT_INTERVAL, 0};
+	// nothing written yet: the first pass saves the board dealt (or restored) at startup
+	unsigned long written = ULONG_MAX;
+	int signalNumber;
 
-	// Mark all words as not found
-	while (temp){
-		temp->isFound = 0;
-		temp = temp->next;
+	while (1){
+		signalNumber = sigtimedwait(&shutdownSignals, NULL, &interval);
+		if (signalNumber > 0){
+			writeGameSnapshot();
+			LOG(LOG_INFO, "event=shutdown signal=%d snapshot=%s", signalNumber, snapshotPath);
+			logFlush();
+			exit(0);
+		}
+		if (atomic_load(&gameStateVersion) == written){
+			continue;
+		}
+		written = atomic_load(&gameStateVersion);
+		writeGameSnapshot();
 	}
+	return NULL;
 }
 /*
- * cleanupGameListNode - Frees all nodes in the game list, releasing memory.
+ * writeGameSnapshot - Writes the puzzle being played and the prepared one to snapshotPath.
+ *                     The state version is read before the found words, so a restored
+ *                     board never shows less than its version says.
  *
  * Parameters:
  *  None
  *
  * Return:
- *  void - This function does not return a value.
+ *  int - 0 on success, -1 on failure.
  */
-void cleanupGameListNode(){
-	//error check
-	if (gameRoot == NULL){
-		return;
+int writeGameSnapshot(){
+	struct puzzle *puzzles[SNAPSHOT_MAX_PUZZLES];
+	unsigned long version;
+	unsigned long long start = nowNanoseconds();
+	int puzzleCount = 0, result;
+
+	pthread_mutex_lock(&puzzleLock);
+	version = atomic_load(&gameStateVersion);
+	puzzles[puzzleCount++] = currentPuzzle;
+	if (nextPuzzle != NULL){
+		puzzles[puzzleCount++] = nextPuzzle;
 	}
-	// Temporary pointer to free each node in the game list
-	struct gameListNode *temp = NULL;
+	for (int i = 0; i < puzzleCount; i++){
+		atomic_fetch_add(&puzzles[i]->refCount, 1);
+	}
+	pthread_mutex_unlock(&puzzleLock);
 
-	// Loop through and free each node
-	while (gameRoot){
-		temp = gameRoot;
-		gameRoot = gameRoot->next;
-		free(temp);
+	result = saveSnapshot(snapshotPath, puzzles, puzzleCount, version);
+	for (int i = 0; i < puzzleCount; i++){
+		releasePuzzle(puzzles[i]);
 	}
-}
-/*
- * cleanupWordListNode - Frees all nodes in the word list, releasing memory.
- *
- * Parameters:
- *  None
- *
- * Return:
- *  void - This function does not return a value.
- */
-void cleanupWordListNode(){
-	//error check
-	if (wordRoot == NULL){
-		return;
+	if (result == -1){
+		atomic_fetch_add_explicit(&snapshotFailedTotal, 1, memory_order_relaxed);
+		return -1;
 	}
-    	// Temporary pointer to free each node in the word list
-    	struct wordListNode *temp;
-    
-    	// Loop through and free each node
-    	while (wordRoot){
-        	temp = wordRoot;
-        	wordRoot = wordRoot->next;
-        	free(temp);
-    	}
+	atomic_fetch_add_explicit(&snapshotTotal, 1, memory_order_relaxed);
+	LOG(LOG_DEBUG, "event=snapshot_written path=%s version=%lu puzzles=%d duration_us=%llu", snapshotPath,
+		version, puzzleCount, (nowNanoseconds() - start) / 1000);
+	return 0;
 }
@@ -0,0 +1,460 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Closed-loop HTTP load generator for the game server, loopback only. Every connection
+ *              thread replays a fixed mix of page loads, correct guesses, wrong guesses and 404s and
+ *              times each request end to end. The puzzle is rebuilt locally from the same seed and
+ *              dictionary as the server, so correct guesses are known without scraping the page.
+ *              The longest word is never guessed, which keeps the board (and the run) from rolling over.
+ *              Usage: loadGenerator [-S server] [-p port] [-c connections] [-d seconds] [-s seed]
+ *                                   [-m page:correct:wrong:notfound] [-D dictionary] [-L listeners] [-z encoding]
+ *              -S starts the given server binary with -s <seed> next to the dictionary and stops it
+ *              afterwards, -L hands it -l <listeners>. -z sends Accept-Encoding: <encoding>.
+ *              Prints one JSON line with throughput, p50/p99/p999 latency, the "Server Full" (503)
+ *              rejection rate and the average response size on the wire.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <signal.h>
+#include <libgen.h>
+#include <errno.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "wordEngine.h"
+#include "logger.h"
+#include "metrics.h"
+
+#ifndef BENCH_DICTIONARY
+#define BENCH_DICTIONARY "2of12.txt"
+#endif
+
+//Request kinds of the replayed mix
+#define REQUEST_PAGE 0
+#define REQUEST_CORRECT 1
+#define REQUEST_WRONG 2
+#define REQUEST_NOT_FOUND 3
+#define REQUEST_KINDS 4
+
+//Outcome of one request
+#define OUTCOME_OK 0
+#define OUTCOME_NOT_FOUND 1
+#define OUTCOME_REJECTED 2
+#define OUTCOME_ERROR 3
+
+//Per connection thread state and results
+struct loadWorker{
+	pthread_t id;
+	unsigned int seed;
+	unsigned long long *latency;
+	unsigned long latencyCount;
+	unsigned long latencyCapacity;
+	unsigned long outcome[4];
+	unsigned long long bytes;
+};
+
+//function prototype
+void *loadWorkerRun(void *value);
+int sendRequest(const char *path, unsigned long long *latency, unsigned long long *bytes);
+int pickRequest(unsigned int *seed);
+int compareLatency(const void *a, const void *b);
+pid_t startServer(const char *server);
+int waitForServer(int seconds);
+
+//Global variable
+int port = 8000;
+int durationSeconds = 10;
+int mix[REQUEST_KINDS] = {40, 25, 25, 10};
+int mixTotal = 100;
+unsigned int seed = 12345;
+//Correct guesses (every word of the seeded puzzle but the longest) and wrong ones
+char **correctGuess = NULL;
+int correctGuessCount = 0;
+const char *wrongGuess[] = {"qzx", "zzzz", "xylophonez", "aaaaa", "qwerty", "jjj"};
+atomic_int running = 1;
+//Page request: the server only serves names that exist in its directory, the dictionary does
+char pageName[256];
+//1 when -D picked a word list, the server then has to load the same one
+int customDictionary = 0;
+//SO_REUSEPORT listeners of a server started with -S, 0 leaves the server's default
+int serverListeners = 0;
+//Accept-Encoding sent with every request (-z), NULL sends none
+const char *acceptEncoding = NULL;
+
+//main
+int main(int argc, char **argv){
+	int connections = 16, option;
+	const char *server = NULL;
+	struct loadWorker *worker;
+	struct puzzle *puzzle;
+	struct gameListNode *longest = NULL;
+	unsigned long long start, elapsed, *latency, total = 0, ok = 0, rejected = 0, notFound = 0, errors = 0, bytes = 0;
+	unsigned long count = 0;
+	pid_t serverPid = -1;
+
+	dictionaryPath = BENCH_DICTIONARY;
+	while ((option = getopt(argc, argv, "S:p:c:d:s:m:D:L:z:")) != -1){
+		switch (option){
+			case 'S': server = optarg; break;
+			case 'p': port = atoi(optarg); break;
+			case 'c': connections = atoi(optarg); break;
+			case 'd': durationSeconds = atoi(optarg); break;
+			case 's': seed = (unsigned int)strtoul(optarg, NULL, 10); break;
+			case 'D': dictionaryPath = optarg; customDictionary = 1; break;
+			case 'L': serverListeners = atoi(optarg); break;
+			case 'z': acceptEncoding = optarg; break;
+			case 'm':
+				if (sscanf(optarg, "%d:%d:%d:%d", &mix[0], &mix[1], &mix[2], &mix[3]) != 4){
+					fprintf(stderr, "-m expects page:correct:wrong:notfound weights\n");
+					return 1;
+				}
+				break;
+			default:
+				fprintf(stderr, "Usage: %s [-S server] [-p port] [-c connections] [-d seconds] [-s seed]"
+					" [-m page:correct:wrong:notfound] [-D dictionary] [-L listeners] [-z encoding]\n", argv[0]);
+				return 1;
+		}
+	}
+	mixTotal = mix[0] + mix[1] + mix[2] + mix[3];
+	if (connections < 1 || durationSeconds < 1 || mixTotal < 1){
+		fprintf(stderr, "connections, duration and mix must be positive\n");
+		return 1;
+	}
+	logLevel = LOG_OFF;
+	signal(SIGPIPE, SIG_IGN);
+
+	// Rebuild the server's first puzzle: same dictionary, same seed
+	int wordCount = initialization();
+	if (wordCount == 0){
+		fprintf(stderr, "Could not load the dictionary %s\n", dictionaryPath);
+		return 1;
+	}
+	char dictionaryCopy[4096];
+	snprintf(dictionaryCopy, sizeof(dictionaryCopy), "%s", dictionaryPath);
+	snprintf(pageName, sizeof(pageName), "%s", basename(dictionaryCopy));
+	seedRandomWord(seed);
+	puzzle = buildPuzzle();
+	if (puzzle == NULL){
+		fprintf(stderr, "Could not build a puzzle from %s\n", dictionaryPath);
+		return 1;
+	}
+	correctGuess = (char **)malloc(sizeof(char *) * puzzle->wordCount);
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		if (longest == NULL || strlen(temp->str) > strlen(longest->str)){
+			longest = temp;
+		}
+	}
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		if (temp != longest){
+			correctGuess[correctGuessCount++] = temp->str;
+		}
+	}
+	if (correctGuessCount == 0){
+		mix[REQUEST_WRONG] += mix[REQUEST_CORRECT];
+		mix[REQUEST_CORRECT] = 0;
+	}
+
+	if (server != NULL){
+		serverPid = startServer(server);
+		if (serverPid == -1 || waitForServer(60) == -1){
+			fprintf(stderr, "Server did not come up on port %d\n", port);
+			if (serverPid != -1){
+				kill(serverPid, SIGTERM);
+			}
+			return 1;
+		}
+	}
+	else if (waitForServer(1) == -1){
+		fprintf(stderr, "No server listening on port %d (use -S to start one)\n", port);
+		return 1;
+	}
+
+	// Closed loop: every connection thread issues its next request as soon as the last one is done
+	worker = (struct loadWorker *)calloc(connections, sizeof(struct loadWorker));
+	start = nowNanoseconds();
+	for (int i = 0; i < connections; i++){
+		worker[i].seed = seed + i + 1;
+		pthread_create(&worker[i].id, NULL, loadWorkerRun, &worker[i]);
+	}
+	sleep(durationSeconds);
+	atomic_store(&running, 0);
+	for (int i = 0; i < connections; i++){
+		pthread_join(worker[i].id, NULL);
+	}
+	elapsed = nowNanoseconds() - start;
+
+	if (serverPid != -1){
+		kill(serverPid, SIGTERM);
+		waitpid(serverPid, NULL, 0);
+	}
+
+	// Merge every thread's samples
+	for (int i = 0; i < connections; i++){
+		count += worker[i].latencyCount;
+		ok += worker[i].outcome[OUTCOME_OK];
+		notFound += worker[i].outcome[OUTCOME_NOT_FOUND];
+		rejected += worker[i].outcome[OUTCOME_REJECTED];
+		errors += worker[i].outcome[OUTCOME_ERROR];
+		bytes += worker[i].bytes;
+	}
+	latency = (unsigned long long *)malloc(sizeof(unsigned long long) * (count + 1));
+	count = 0;
+	for (int i = 0; i < connections; i++){
+		memcpy(latency + count, worker[i].latency, sizeof(unsigned long long) * worker[i].latencyCount);
+		count += worker[i].latencyCount;
+		free(worker[i].latency);
+	}
+	qsort(latency, count, sizeof(unsigned long long), compareLatency);
+	total = ok + notFound + rejected + errors;
+
+	printf("{\"connections\":%d,\"duration_s\":%.3f,\"seed\":%u,\"mix\":\"%d:%d:%d:%d\",\"requests\":%llu,"
+		"\"ok\":%llu,\"not_found\":%llu,\"rejected\":%llu,\"errors\":%llu,\"throughput_rps\":%.1f,"
+		"\"rejection_rate\":%.4f,\"p50_us\":%.1f,\"p99_us\":%.1f,\"p999_us\":%.1f,\"max_us\":%.1f,"
+		"\"encoding\":\"%s\",\"bytes_per_response\":%.0f}\n",
+		connections, elapsed / 1e9, seed, mix[0], mix[1], mix[2], mix[3], total, ok, notFound, rejected, errors,
+		total * 1e9 / elapsed, total ? (double)rejected / total : 0.0,
+		count ? latency[(unsigned long)(count * 0.50)] / 1e3 : 0.0,
+		count ? latency[(unsigned long)(count * 0.99)] / 1e3 : 0.0,
+		count ? latency[(unsigned long)(count * 0.999)] / 1e3 : 0.0,
+		count ? latency[count - 1] / 1e3 : 0.0, acceptEncoding ? acceptEncoding : "identity",
+		count ? (double)bytes / count : 0.0);
+
+	free(latency);
+	free(worker);
+	free(correctGuess);
+	releasePuzzle(puzzle);
+	cleanupDictionary();
+	return 0;
+}
+
+/*
+ * Function: loadWorkerRun
+ * -----------------------
+ * Connection thread: replays the request mix until the run is over, recording the
+ * latency of every answered request and the outcome of every attempt.
+ *
+ * Parameters:
+ *      value - the thread's struct loadWorker
+ *
+ * Return:
+ *      void* - Returns NULL when the run is over.
+ */
+void *loadWorkerRun(void *value){
+	struct loadWorker *worker = (struct loadWorker *)value;
+	// Room for the page name and the longest guess, so no path is ever cut short
+	char path[sizeof(pageName) + MAX_WORD_LENGTH + 16];
+	unsigned long long latency;
+	int outcome;
+
+	while (atomic_load(&running)){
+		switch (pickRequest(&worker->seed)){
+			case REQUEST_PAGE:
+				snprintf(path, sizeof(path), "/%s", pageName);
+				break;
+			case REQUEST_CORRECT:
+				snprintf(path, sizeof(path), "/%s?move=%s", pageName, correctGuess[rand_r(&worker->seed) % correctGuessCount]);
+				break;
+			case REQUEST_WRONG:
+				snprintf(path, sizeof(path), "/%s?move=%s", pageName,
+					wrongGuess[rand_r(&worker->seed) % (sizeof(wrongGuess) / sizeof(wrongGuess[0]))]);
+				break;
+			default:
+				snprintf(path, sizeof(path), "/missing-%u.html", rand_r(&worker->seed) % 1000);
+				break;
+		}
+		outcome = sendRequest(path, &latency, &worker->bytes);
+		worker->outcome[outcome]++;
+		if (outcome == OUTCOME_ERROR){
+			continue;
+		}
+		if (worker->latencyCount == worker->latencyCapacity){
+			worker->latencyCapacity = worker->latencyCapacity ? worker->latencyCapacity * 2 : 4096;
+			worker->latency = (unsigned long long *)realloc(worker->latency,
+				sizeof(unsigned long long) * worker->latencyCapacity);
+		}
+		worker->latency[worker->latencyCount++] = latency;
+	}
+	return NULL;
+}
+
+/*
+ * Function: pickRequest
+ * ---------------------
+ * Draws the next request kind according to the configured mix weights.
+ *
+ * Parameters:
+ *      seed - the calling thread's rand_r state
+ *
+ * Return:
+ *      int - REQUEST_PAGE, REQUEST_CORRECT, REQUEST_WRONG or REQUEST_NOT_FOUND.
+ */
+int pickRequest(unsigned int *seed){
+	int draw = rand_r(seed) % mixTotal;
+
+	for (int kind = 0; kind < REQUEST_KINDS; kind++){
+		if (draw < mix[kind]){
+			return kind;
+		}
+		draw -= mix[kind];
+	}
+	return REQUEST_PAGE;
+}
+
+/*
+ * Function: sendRequest
+ * ---------------------
+ * Opens a loopback connection, sends one GET and reads the response until the
+ * server closes the connection. "Server Full" comes as 503 Service Unavailable.
+ *
+ * Parameters:
+ *      path    - request path including the query string
+ *      latency - receives the time from connect to the end of the response
+ *      bytes   - response bytes received are added to it
+ *
+ * Return:
+ *      int - OUTCOME_OK, OUTCOME_NOT_FOUND, OUTCOME_REJECTED or OUTCOME_ERROR.
+ */
+int sendRequest(const char *path, unsigned long long *latency, unsigned long long *bytes){
+	struct sockaddr_in address;
+	struct timeval timeout = {5, 0};
+	char request[600], response[4096];
+	unsigned long long start = nowNanoseconds();
+	ssize_t received;
+	size_t head = 0;
+	int clientSocket, outcome = OUTCOME_ERROR;
+
+	clientSocket = socket(AF_INET, SOCK_STREAM, 0);
+	if (clientSocket == -1){
+		return OUTCOME_ERROR;
+	}
+	setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (connect(clientSocket, (struct sockaddr *)&address, sizeof(address)) == -1){
+		close(clientSocket);
+		return OUTCOME_ERROR;
+	}
+
+	if (snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: localhost\r\n%s%s%s\r\n", path,
+			acceptEncoding ? "Accept-Encoding: " : "", acceptEncoding ? acceptEncoding : "", acceptEncoding ? "\r\n" : "") >= (int)sizeof(request)){
+		close(clientSocket);
+		return OUTCOME_ERROR;
+	}
+	if (send(clientSocket, request, strlen(request), MSG_NOSIGNAL) != (ssize_t)strlen(request)){
+		close(clientSocket);
+		return OUTCOME_ERROR;
+	}
+
+	// Keep the first bytes to classify the answer, drain the rest
+	while ((received = recv(clientSocket, response + head, sizeof(response) - 1 - head, 0)) > 0){
+		head += received;
+		*bytes += received;
+		response[head] = '\0';
+		if (head == sizeof(response) - 1){
+			head = 32;
+		}
+	}
+	if (received == 0){
+		if (strncmp(response, "HTTP/1.1 200", 12) == 0){
+			outcome = OUTCOME_OK;
+		}
+		else if (strncmp(response, "HTTP/1.1 404", 12) == 0){
+			outcome = OUTCOME_NOT_FOUND;
+		}
+		else if (strncmp(response, "HTTP/1.1 503", 12) == 0){
+			outcome = OUTCOME_REJECTED;
+		}
+	}
+	*latency = nowNanoseconds() - start;
+	close(clientSocket);
+	return outcome;
+}
+
+/*
+ * Function: compareLatency
+ * ------------------------
+ * qsort comparator for latency samples.
+ */
+int compareLatency(const void *a, const void *b){
+	unsigned long long left = *(const unsigned long long *)a, right = *(const unsigned long long *)b;
+	return left < right ? -1 : left > right;
+}
+
+/*
+ * Function: startServer
+ * ---------------------
+ * Starts the server binary with the run's seed, in the dictionary's directory (its
+ * pages are served from there) with logging off. A -D word list is handed on with -d,
+ * -L with -l.
+ *
+ * Parameters:
+ *      server - path of the server executable
+ *
+ * Return:
+ *      pid_t - Process id of the server, or -1 if it could not be started.
+ */
+pid_t startServer(const char *server){
+	char seedText[20], listenerText[20], serverPath[4096], dictionaryDir[4096];
+	char *serverArgv[10];
+	int serverArgc = 0;
+	pid_t pid;
+
+	if (realpath(server, serverPath) == NULL){
+		return -1;
+	}
+	snprintf(dictionaryDir, sizeof(dictionaryDir), "%s", dictionaryPath);
+	snprintf(seedText, sizeof(seedText), "%u", seed);
+	snprintf(listenerText, sizeof(listenerText), "%d", serverListeners);
+	serverArgv[serverArgc++] = serverPath;
+	serverArgv[serverArgc++] = "-s";
+	serverArgv[serverArgc++] = seedText;
+	if (customDictionary == 1){
+		serverArgv[serverArgc++] = "-d";
+		serverArgv[serverArgc++] = pageName;
+	}
+	if (serverListeners > 0){
+		serverArgv[serverArgc++] = "-l";
+		serverArgv[serverArgc++] = listenerText;
+	}
+	serverArgv[serverArgc++] = ".";
+	serverArgv[serverArgc] = NULL;
+	pid = fork();
+	if (pid == 0){
+		if (chdir(dirname(dictionaryDir)) == -1){
+			_exit(127);
+		}
+		setenv("WWF_LOG_LEVEL", "off", 1);
+		execv(serverPath, serverArgv);
+		_exit(127);
+	}
+	return pid;
+}
+
+/*
+ * Function: waitForServer
+ * -----------------------
+ * Polls the port until the server accepts connections.
+ *
+ * Parameters:
+ *      seconds - how long to keep trying
+ *
+ * Return:
+ *      int - 0 once the server answers, or -1 after the timeout.
+ */
+int waitForServer(int seconds){
+	unsigned long long latency, bytes = 0;
+
+	for (int i = 0; i < seconds * 10; i++){
+		if (sendRequest("/", &latency, &bytes) != OUTCOME_ERROR){
+			return 0;
+		}
+		usleep(100000);
+	}
+	return -1;
+}
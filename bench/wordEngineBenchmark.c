@@ -0,0 +1,579 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Microbenchmarks for the word engine kernels: initialization (from the file and from the
+ *              embedded tables, the file load includes the puzzle index), getLetterDistribution,
+ *              compareCounts, canFormWord, validateWords (every dictionary word as a candidate), pickMasterWord, findWords over every eligible master word,
+ *              acceptInput, displayWord and displayGameList, plus the server's connection timer wheel
+ *              (arm, cancel and expire of 100000 deadlines) and scoring (recordScore on a correct guess,
+ *              applyScoreEvents in the score keeper). Runs against the bundled 2of12.txt with a fixed seed so
+ *              results are comparable between builds.
+ *              Usage: wordEngineBenchmark [dictionary] [seed] [masterWordStride]
+ *              Prints one JSON object per benchmark and line, e.g.
+ *              {"benchmark":"findWords","ops":29004,"total_ns":...,"ns_per_op":...,"ops_per_sec":...}
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wordEngine.h"
+#include "dictionary.h"
+#include "puzzleIndex.h"
+#include "logger.h"
+#include "metrics.h"
+#include "timerWheel.h"
+#include "scoreboard.h"
+
+#ifndef BENCH_DICTIONARY
+#define BENCH_DICTIONARY "2of12.txt"
+#endif
+
+//function prototype
+void reportResult(const char *name, unsigned long long ops, unsigned long long start);
+void benchInitialization(int runs);
+void benchEmbeddedInitialization(int runs);
+void benchCanFormWord(int rounds);
+void benchValidateWords(int rounds);
+void benchPickMasterWord(int runs);
+void benchLetterDistribution(int rounds);
+void benchCompareCounts(int rounds);
+void benchFindWords(int stride);
+void benchAcceptInput(int rounds);
+void benchDisplayWord(int runs);
+void benchDisplayGameList(int runs);
+void benchTimerWheel(int timers);
+void benchScoreEvents(int rounds);
+void countExpired(struct wheelTimer *timer, void *value);
+char *wordCopy(int index);
+
+//Global variable
+unsigned int seed = 12345;
+int dictionaryWordCount = 0;
+//Keeps the compiler from optimizing benchmarked results away
+volatile unsigned long long sink = 0;
+
+//main
+int main(int argc, char **argv){
+	int stride = 1;
+
+	dictionaryPath = argc > 1 ? argv[1] : BENCH_DICTIONARY;
+	if (argc > 2){
+		seed = (unsigned int)strtoul(argv[2], NULL, 10);
+	}
+	if (argc > 3){
+		stride = atoi(argv[3]) > 0 ? atoi(argv[3]) : 1;
+	}
+	// Nothing drains the log rings here, and formatting must not skew the timings
+	logLevel = LOG_OFF;
+
+	benchInitialization(3);
+	if (dictionaryWordCount == 0){
+		fprintf(stderr, "Could not load the dictionary %s\n", dictionaryPath);
+		return 1;
+	}
+	benchEmbeddedInitialization(1000);
+	benchLetterDistribution(20);
+	benchCompareCounts(50);
+	benchCanFormWord(50);
+	benchValidateWords(20);
+	benchPickMasterWord(1000000);
+	benchFindWords(stride);
+	benchAcceptInput(200);
+	benchDisplayWord(200000);
+	benchDisplayGameList(20000);
+	benchTimerWheel(100000);
+	benchScoreEvents(100);
+
+	cleanupDictionary();
+	return 0;
+}
+
+/*
+ * Function: reportResult
+ * ----------------------
+ * Prints one benchmark result as a JSON line.
+ *
+ * Parameters:
+ *      name  - benchmark name
+ *      ops   - number of operations timed
+ *      start - nowNanoseconds() when the timed loop started
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void reportResult(const char *name, unsigned long long ops, unsigned long long start){
+	unsigned long long elapsed = nowNanoseconds() - start;
+
+	printf("{\"benchmark\":\"%s\",\"seed\":%u,\"dictionary_words\":%d,\"ops\":%llu,\"total_ns\":%llu,"
+		"\"ns_per_op\":%.1f,\"ops_per_sec\":%.0f}\n", name, seed, dictionaryWordCount, ops, elapsed,
+		ops ? (double)elapsed / ops : 0.0, elapsed ? ops * 1e9 / elapsed : 0.0);
+	fflush(stdout);
+}
+
+/*
+ * Function: benchInitialization
+ * -----------------------------
+ * Loads the whole dictionary from disk, from scratch, several times.
+ *
+ * Parameters:
+ *      runs - number of loads
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchInitialization(int runs){
+	unsigned long long start = nowNanoseconds();
+
+	for (int i = 0; i < runs; i++){
+		cleanupDictionary();
+		dictionaryWordCount = initialization();
+	}
+	reportResult("initialization", runs, start);
+	// initialization seeds from the clock, pin the puzzle sequence again
+	seedRandomWord(seed);
+}
+
+/*
+ * Function: benchEmbeddedInitialization
+ * -------------------------------------
+ * Sets up the dictionary compiled into the binary, when the build has one. The file
+ * loaded by benchInitialization is put back afterwards.
+ *
+ * Parameters:
+ *      runs - number of set ups
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchEmbeddedInitialization(int runs){
+	struct dictionary *loaded = wordDictionary;
+	const char *path = dictionaryPath;
+	unsigned long long start;
+
+	if (embeddedDictionary() == NULL){
+		return;
+	}
+	dictionaryPath = NULL;
+	start = nowNanoseconds();
+	for (int i = 0; i < runs; i++){
+		wordDictionary = NULL;
+		sink += initialization();
+	}
+	reportResult("initialization_embedded", runs, start);
+	wordDictionary = loaded;
+	dictionaryPath = path;
+	seedRandomWord(seed);
+}
+
+/*
+ * Function: wordCopy
+ * ------------------
+ * Terminated copy of a dictionary word, for the kernels that take C strings.
+ *
+ * Parameters:
+ *      index - dictionary index
+ *
+ * Return:
+ *      char* - The copy, owned by the caller.
+ */
+char *wordCopy(int index){
+	char *word = (char *)malloc(wordDictionary->length[index] + 1);
+
+	memcpy(word, dictionaryWord(wordDictionary, index), wordDictionary->length[index]);
+	word[wordDictionary->length[index]] = '\0';
+	return word;
+}
+
+/*
+ * Function: benchLetterDistribution
+ * ---------------------------------
+ * Computes the letter histogram of every dictionary word.
+ *
+ * Parameters:
+ *      rounds - passes over the dictionary
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchLetterDistribution(int rounds){
+	char **words = (char **)malloc(sizeof(char *) * dictionaryWordCount);
+	unsigned long long start;
+	int *counts;
+
+	for (int i = 0; i < dictionaryWordCount; i++){
+		words[i] = wordCopy(i);
+	}
+	start = nowNanoseconds();
+	for (int round = 0; round < rounds; round++){
+		for (int i = 0; i < dictionaryWordCount; i++){
+			counts = getLetterDistribution(words[i]);
+			sink += counts[0];
+			free(counts);
+		}
+	}
+	reportResult("getLetterDistribution", (unsigned long long)rounds * dictionaryWordCount, start);
+
+	for (int i = 0; i < dictionaryWordCount; i++){
+		free(words[i]);
+	}
+	free(words);
+}
+
+/*
+ * Function: benchCompareCounts
+ * ----------------------------
+ * Compares a fixed master word against the precomputed histogram of every dictionary word.
+ *
+ * Parameters:
+ *      rounds - passes over the dictionary
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchCompareCounts(int rounds){
+	int **counts = (int **)malloc(sizeof(int *) * dictionaryWordCount);
+	char *word;
+	int *masterCounts, i;
+	unsigned long long start;
+
+	for (i = 0; i < dictionaryWordCount; i++){
+		word = wordCopy(i);
+		counts[i] = getLetterDistribution(word);
+		free(word);
+	}
+	masterCounts = getLetterDistribution((char *)getRandomWord(wordDictionary));
+
+	start = nowNanoseconds();
+	for (int round = 0; round < rounds; round++){
+		for (i = 0; i < dictionaryWordCount; i++){
+			sink += compareCounts(masterCounts, counts[i]);
+		}
+	}
+	reportResult("compareCounts", (unsigned long long)rounds * dictionaryWordCount, start);
+
+	for (i = 0; i < dictionaryWordCount; i++){
+		free(counts[i]);
+	}
+	free(counts);
+	free(masterCounts);
+}
+
+/*
+ * Function: benchCanFormWord
+ * --------------------------
+ * Same comparison as benchCompareCounts on the dictionary's precomputed histogram rows
+ * (the vectorized kernel behind findWords, without the length and mask prefilter).
+ *
+ * Parameters:
+ *      rounds - passes over the dictionary
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchCanFormWord(int rounds){
+	_Alignas(16) unsigned char available[HISTOGRAM_WIDTH];
+	const char *masterWord = getRandomWord(wordDictionary);
+	unsigned long long start;
+
+	letterHistogram(masterWord, strlen(masterWord), available);
+	start = nowNanoseconds();
+	for (int round = 0; round < rounds; round++){
+		for (int i = 0; i < dictionaryWordCount; i++){
+			sink += canFormWord(available, wordDictionary->histogram[i]);
+		}
+	}
+	reportResult("canFormWord", (unsigned long long)rounds * dictionaryWordCount, start);
+}
+
+/*
+ * Function: benchValidateWords
+ * ----------------------------
+ * Checks every dictionary word, as a NUL-terminated candidate string, against the
+ * letters of a master word the way /validate does (histograms built per request).
+ *
+ * Parameters:
+ *      rounds - passes over the dictionary
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchValidateWords(int rounds){
+	char **words = (char **)malloc(sizeof(char *) * dictionaryWordCount);
+	unsigned char *results = (unsigned char *)malloc(dictionaryWordCount);
+	const char *rack = getRandomWord(wordDictionary);
+	unsigned long long start;
+
+	for (int i = 0; i < dictionaryWordCount; i++){
+		words[i] = wordCopy(i);
+	}
+	start = nowNanoseconds();
+	for (int round = 0; round < rounds; round++){
+		sink += validateWords(rack, (const char **)words, dictionaryWordCount, results);
+	}
+	reportResult("validateWords", (unsigned long long)rounds * dictionaryWordCount, start);
+
+	for (int i = 0; i < dictionaryWordCount; i++){
+		free(words[i]);
+	}
+	free(words);
+	free(results);
+}
+
+/*
+ * Function: benchPickMasterWord
+ * -----------------------------
+ * Picks master words with 20 to 80 words on the board from the puzzle index.
+ *
+ * Parameters:
+ *      runs - number of picks
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchPickMasterWord(int runs){
+	unsigned int pickSeed = seed;
+	unsigned long long start = nowNanoseconds();
+
+	for (int i = 0; i < runs; i++){
+		sink += pickMasterWord(wordDictionary, 20, 80, &pickSeed);
+	}
+	reportResult("pickMasterWord", runs, start);
+}
+
+/*
+ * Function: benchFindWords
+ * ------------------------
+ * Builds the game list of every eligible master word (longer than 6 letters, the
+ * same rule getRandomWord applies).
+ *
+ * Parameters:
+ *      stride - only every stride-th eligible master word is used (1 = all of them)
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchFindWords(int stride){
+	unsigned long long start = nowNanoseconds(), ops = 0;
+	struct gameListNode *gameRoot;
+	char *masterWord;
+	int eligible = 0;
+
+	for (int i = 0; i < dictionaryWordCount; i++){
+		if (wordDictionary->length[i] <= 6 || eligible++ % stride != 0){
+			continue;
+		}
+		masterWord = wordCopy(i);
+		gameRoot = findWords(wordDictionary, masterWord);
+		free(masterWord);
+		sink += gameRoot != NULL;
+		cleanupGameListNode(gameRoot);
+		ops++;
+	}
+	reportResult("findWords", ops, start);
+}
+
+/*
+ * Function: benchAcceptInput
+ * --------------------------
+ * Plays every word of a seeded puzzle plus as many wrong guesses against it,
+ * resetting the board after each round.
+ *
+ * Parameters:
+ *      rounds - passes over the guess list
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchAcceptInput(int rounds){
+	struct puzzle *puzzle = buildPuzzle();
+	char **guesses = (char **)malloc(sizeof(char *) * puzzle->wordCount * 2);
+	char input[30];
+	int guessCount = 0;
+	unsigned long long start, elapsed = 0, ops = 0;
+	char (*wrongWord)[30] = malloc(sizeof(*wrongWord) * puzzle->wordCount);
+	int wrong = 0, wrongCount = 0;
+
+	// Every game word, each followed by a dictionary word that is not on the board
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		guesses[guessCount++] = temp->str;
+		while (wrong < dictionaryWordCount && wordDictionary->length[wrong] < 3){
+			wrong++;
+		}
+		if (wrong < dictionaryWordCount){
+			memcpy(wrongWord[wrongCount], dictionaryWord(wordDictionary, wrong), wordDictionary->length[wrong]);
+			wrongWord[wrongCount][wordDictionary->length[wrong++]] = '\0';
+			guesses[guessCount++] = wrongWord[wrongCount++];
+		}
+	}
+
+	for (int round = 0; round < rounds; round++){
+		setAllWordsToNotFound(puzzle->gameRoot);
+		atomic_store(&puzzle->foundCount, 0);
+		start = nowNanoseconds();
+		for (int i = 0; i < guessCount; i++){
+			// acceptInput uppercases in place, keep the guess list intact
+			strcpy(input, guesses[i]);
+			acceptInput(puzzle, input);
+		}
+		elapsed += nowNanoseconds() - start;
+		ops += guessCount;
+	}
+	reportResult("acceptInput", ops, nowNanoseconds() - elapsed);
+
+	free(guesses);
+	free(wrongWord);
+	releasePuzzle(puzzle);
+}
+
+/*
+ * Function: benchDisplayWord
+ * --------------------------
+ * Renders the sorted rack of a seeded master word.
+ *
+ * Parameters:
+ *      runs - number of renders
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchDisplayWord(int runs){
+	struct puzzle *puzzle = buildPuzzle();
+	unsigned long long start = nowNanoseconds();
+	char *letters;
+
+	for (int i = 0; i < runs; i++){
+		letters = displayWord(puzzle->masterWord);
+		sink += letters[0];
+		free(letters);
+	}
+	reportResult("displayWord", runs, start);
+	releasePuzzle(puzzle);
+}
+
+/*
+ * Function: benchDisplayGameList
+ * ------------------------------
+ * Renders the board of a seeded puzzle with every other word found.
+ *
+ * Parameters:
+ *      runs - number of renders
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchDisplayGameList(int runs){
+	struct puzzle *puzzle = buildPuzzle();
+	unsigned long long start;
+	char *board;
+	int i = 0;
+
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		atomic_store(&temp->isFound, i++ % 2);
+	}
+	start = nowNanoseconds();
+	for (i = 0; i < runs; i++){
+		board = displayGameList(puzzle->gameRoot);
+		sink += board[0];
+		free(board);
+	}
+	reportResult("displayGameList", runs, start);
+	releasePuzzle(puzzle);
+}
+
+/*
+ * Function: countExpired
+ * ----------------------
+ * Timer wheel callback of benchTimerWheel, counts expirations.
+ */
+void countExpired(struct wheelTimer *timer, void *value){
+	(*(unsigned long long *)value)++;
+}
+
+/*
+ * Function: benchTimerWheel
+ * -------------------------
+ * Connection deadline pattern of the server: arms timers 10ms to 30s out, re-arms each
+ * once (a worker moving from the header to the write deadline), cancels half of them and
+ * lets the clock run until the rest expired. One op is one arm, cancel or expiration.
+ *
+ * Parameters:
+ *      timers - number of timers
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchTimerWheel(int timers){
+	static struct timerWheel wheel;
+	struct wheelTimer *timer = (struct wheelTimer *)calloc(timers, sizeof(struct wheelTimer));
+	unsigned long long now = 0, expired = 0, start;
+	unsigned int timerSeed = seed;
+
+	if (timer == NULL){
+		return;
+	}
+	initTimerWheel(&wheel, now);
+	start = nowNanoseconds();
+	for (int i = 0; i < timers; i++){
+		armTimer(&wheel, &timer[i], now + (10 + rand_r(&timerSeed) % 30000) * 1000000ULL);
+	}
+	for (int i = 0; i < timers; i++){
+		armTimer(&wheel, &timer[i], now + (10 + rand_r(&timerSeed) % 30000) * 1000000ULL);
+	}
+	for (int i = 0; i < timers; i += 2){
+		cancelTimer(&wheel, &timer[i]);
+	}
+	while (wheel.armedCount > 0){
+		now += WHEEL_TICK_NANOSECONDS;
+		expireTimers(&wheel, now, countExpired, &expired);
+	}
+	reportResult("timerWheel", timers * 2ULL + (timers + 1) / 2 + expired, start);
+	free(timer);
+}
+/*
+ * Function: benchScoreEvents
+ * --------------------------
+ * Scores correct guesses of 1352 players (26 x 26 x 2 names) the way the server does: a queue
+ * full of events is recorded, then drained into the players and leaderboards. The player names
+ * of a round are picked before its clock starts. Recording and applying are timed separately;
+ * one op is one event.
+ *
+ * Parameters:
+ *      rounds - queue fills
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void benchScoreEvents(int rounds){
+	struct scoreEvent event;
+	char (*player)[4] = (char (*)[4])calloc(SCORE_QUEUE_SIZE, 4);
+	unsigned long long recordTime = 0, applyTime = 0, start;
+	unsigned int scoreSeed = seed;
+
+	if (player == NULL){
+		return;
+	}
+	initScoreboard();
+	memset(&event, 0, sizeof(event));
+	event.kind = SCORE_WORDS;
+	event.words = 1;
+	for (int round = 0; round < rounds; round++){
+		event.puzzleId = round / 10 + 1;
+		for (int i = 0; i < SCORE_QUEUE_SIZE; i++){
+			player[i][0] = 'a' + rand_r(&scoreSeed) % 26;
+			player[i][1] = 'a' + rand_r(&scoreSeed) % 26;
+			player[i][2] = '0' + rand_r(&scoreSeed) % 2;
+		}
+		start = nowNanoseconds();
+		for (int i = 0; i < SCORE_QUEUE_SIZE; i++){
+			event.points = 3 + i % 6;
+			memcpy(event.player, player[i], sizeof(player[i]));
+			sink += recordScore(&event);
+		}
+		recordTime += nowNanoseconds() - start;
+		start = nowNanoseconds();
+		sink += applyScoreEvents();
+		applyTime += nowNanoseconds() - start;
+	}
+	// reportResult measures from a start time, shift it by the time spent in the other phase
+	reportResult("recordScore", (unsigned long long)rounds * SCORE_QUEUE_SIZE, nowNanoseconds() - recordTime);
+	reportResult("applyScoreEvents", (unsigned long long)rounds * SCORE_QUEUE_SIZE, nowNanoseconds() - applyTime);
+	free(player);
+}
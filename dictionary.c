@@ -0,0 +1,567 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Dictionary tables, see dictionary.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "dictionary.h"
+#include "logger.h"
+
+//Most loader threads used for one word list
+#define MAX_LOAD_THREADS 64
+//Smallest slice of a word list worth a loader thread of its own
+#define LOAD_CHUNK_MIN (256 * 1024)
+
+//Loader chunk Structure, one slice of the mapped file and the thread indexing it
+struct loadChunk{
+	pthread_t id;
+	const char *start;
+	const char *end;
+	int firstWord;
+	int wordCount;
+	int skipped;
+	//Tables being filled, shared by all chunks
+	const char *bytes;
+	unsigned int *offset;
+	unsigned char *length;
+	unsigned char (*histogram)[HISTOGRAM_WIDTH];
+	unsigned int *mask;
+};
+
+//function prototype
+int nextWord(const char **cursor, const char *end, int *wordLength);
+void *countChunkWords(void *value);
+void *indexChunkWords(void *value);
+void runChunks(struct loadChunk *chunk, int chunkCount, void *(*pass)(void *));
+int candidateHistogram(const char *word, int maxLength, unsigned int missing, unsigned char *histogram);
+
+//Global variable
+struct dictionary *wordDictionary = NULL;
+//Held only to swap wordDictionary or to take a reference on it, never while loading
+pthread_mutex_t dictionaryLock = PTHREAD_MUTEX_INITIALIZER;
+#ifdef WWF_EMBED_DICTIONARY
+//Generated from 2of12.txt at build time (embeddedDictionary.c in the build directory)
+extern struct dictionary embeddedTables;
+#endif
+
+/*
+ * findNewline - Finds the next '\n', 16 bytes per step with SSE2.
+ *
+ * Parameters:
+ *  const char *start - Where to start looking.
+ *  const char *end - End of the buffer (not read).
+ *
+ * Return:
+ *  const char* - The newline, or end if there is none.
+ */
+const char *findNewline(const char *start, const char *end){
+#ifdef __SSE2__
+	const __m128i newline = _mm_set1_epi8('\n');
+
+	for (; start + 16 <= end; start += 16){
+		int hits = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)start), newline));
+		if (hits != 0){
+			return start + __builtin_ctz(hits);
+		}
+	}
+#endif
+	for (; start < end; start++){
+		if (*start == '\n'){
+			return start;
+		}
+	}
+	return end;
+}
+/*
+ * nextWord - Steps over one line of a word list chunk.
+ *
+ * Parameters:
+ *  const char **cursor - Start of the line, moved past its newline.
+ *  const char *end - End of the chunk.
+ *  int *wordLength - Receives the line length without the CR of CRLF lists.
+ *
+ * Return:
+ *  int - 1 if the line holds a word that is kept, otherwise 0 (empty or too long).
+ */
+int nextWord(const char **cursor, const char *end, int *wordLength){
+	const char *newline = findNewline(*cursor, end);
+	size_t lineLength = newline - *cursor;
+
+	if (lineLength > 0 && (*cursor)[lineLength - 1] == '\r'){
+		lineLength--;
+	}
+	*cursor = newline + 1;
+	*wordLength = lineLength;
+	return lineLength > 0 && lineLength <= MAX_WORD_LENGTH;
+}
+/*
+ * countChunkWords - Loader thread, first pass: counts the words its chunk will add.
+ *
+ * Parameters:
+ *  void *value - The chunk's struct loadChunk.
+ *
+ * Return:
+ *  void* - Returns NULL.
+ */
+void *countChunkWords(void *value){
+	struct loadChunk *chunk = (struct loadChunk *)value;
+	const char *cursor = chunk->start;
+	int wordLength;
+
+	while (cursor < chunk->end){
+		if (nextWord(&cursor, chunk->end, &wordLength)){
+			chunk->wordCount++;
+		}
+		else if (wordLength > 0){
+			chunk->skipped++;
+		}
+	}
+	return NULL;
+}
+/*
+ * indexChunkWords - Loader thread, second pass: fills the table rows of its chunk's words,
+ *                   starting at the chunk's first word index.
+ *
+ * Parameters:
+ *  void *value - The chunk's struct loadChunk.
+ *
+ * Return:
+ *  void* - Returns NULL.
+ */
+void *indexChunkWords(void *value){
+	struct loadChunk *chunk = (struct loadChunk *)value;
+	const char *cursor = chunk->start, *word;
+	int wordLength, index = chunk->firstWord;
+
+	while (cursor < chunk->end){
+		word = cursor;
+		if (nextWord(&cursor, chunk->end, &wordLength)){
+			chunk->offset[index] = word - chunk->bytes;
+			chunk->length[index] = wordLength;
+			letterHistogram(word, wordLength, chunk->histogram[index]);
+			chunk->mask[index] = letterMask(chunk->histogram[index]);
+			index++;
+		}
+	}
+	return NULL;
+}
+/*
+ * runChunks - Runs one loader pass over every chunk, one thread each (the first chunk
+ *             on the calling thread).
+ *
+ * Parameters:
+ *  struct loadChunk *chunk - The chunks.
+ *  int chunkCount - Number of chunks.
+ *  void *(*pass)(void *) - countChunkWords or indexChunkWords.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void runChunks(struct loadChunk *chunk, int chunkCount, void *(*pass)(void *)){
+	for (int i = 1; i < chunkCount; i++){
+		// A chunk that gets no thread is done right here
+		if (pthread_create(&chunk[i].id, NULL, pass, &chunk[i]) != 0){
+			chunk[i].id = 0;
+			pass(&chunk[i]);
+		}
+	}
+	pass(&chunk[0]);
+	for (int i = 1; i < chunkCount; i++){
+		if (chunk[i].id != 0){
+			pthread_join(chunk[i].id, NULL);
+		}
+	}
+}
+/*
+ * loadDictionary - Maps a word list (one word per line, LF or CRLF) and indexes it. The file is
+ *                  split into one chunk per core at line boundaries; each chunk's words are
+ *                  counted in parallel, the counts give every chunk its first table row, then
+ *                  the chunks fill their rows in parallel. The words are left in the mapping,
+ *                  the tables only record where each one starts and how long it is.
+ *                  Empty lines and words longer than MAX_WORD_LENGTH are skipped.
+ *
+ * Parameters:
+ *  const char *path - The word list file.
+ *
+ * Return:
+ *  struct dictionary* - The new dictionary, or NULL if the file cannot be read or its tables
+ *                       cannot be allocated.
+ */
+struct dictionary *loadDictionary(const char *path){
+	struct dictionary *dictionary;
+	struct loadChunk chunk[MAX_LOAD_THREADS];
+	struct stat fileStat;
+	const char *bytes, *cut;
+	unsigned int *offset, *mask;
+	unsigned char *length, (*histogram)[HISTOGRAM_WIDTH];
+	int file, chunkCount, wordCount = 0, skipped = 0;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	file = open(path, O_RDONLY);
+	if (file == -1){
+		LOG(LOG_ERROR, "event=dictionary_open_error path=%s", path);
+		return NULL;
+	}
+	// Offsets are 32 bit, and an empty file cannot be mapped
+	if (fstat(file, &fileStat) == -1 || fileStat.st_size == 0 || (unsigned long long)fileStat.st_size > UINT_MAX){
+		LOG(LOG_ERROR, "event=dictionary_read_error path=%s", path);
+		close(file);
+		return NULL;
+	}
+	bytes = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (bytes == MAP_FAILED){
+		LOG(LOG_ERROR, "event=dictionary_map_error path=%s", path);
+		return NULL;
+	}
+	madvise((void *)bytes, fileStat.st_size, MADV_WILLNEED);
+
+	// One chunk per core, none smaller than LOAD_CHUNK_MIN, every cut moved past a newline
+	chunkCount = fileStat.st_size / LOAD_CHUNK_MIN + 1;
+	if (chunkCount > cores){
+		chunkCount = cores > 0 ? cores : 1;
+	}
+	if (chunkCount > MAX_LOAD_THREADS){
+		chunkCount = MAX_LOAD_THREADS;
+	}
+	memset(chunk, 0, sizeof(chunk));
+	chunk[0].start = bytes;
+	for (int i = 1; i < chunkCount; i++){
+		cut = bytes + fileStat.st_size / chunkCount * i;
+		if (cut < chunk[i - 1].start){
+			cut = chunk[i - 1].start;
+		}
+		cut = findNewline(cut, bytes + fileStat.st_size);
+		chunk[i].start = cut < bytes + fileStat.st_size ? cut + 1 : cut;
+		chunk[i - 1].end = chunk[i].start;
+	}
+	chunk[chunkCount - 1].end = bytes + fileStat.st_size;
+
+	runChunks(chunk, chunkCount, countChunkWords);
+	for (int i = 0; i < chunkCount; i++){
+		chunk[i].firstWord = wordCount;
+		wordCount += chunk[i].wordCount;
+		skipped += chunk[i].skipped;
+	}
+	if (skipped > 0){
+		LOG(LOG_WARN, "event=dictionary_words_skipped path=%s count=%d max_length=%d", path, skipped, MAX_WORD_LENGTH);
+	}
+
+	dictionary = (struct dictionary *)malloc(sizeof(struct dictionary));
+	offset = (unsigned int *)malloc(sizeof(unsigned int) * (wordCount + 1));
+	mask = (unsigned int *)malloc(sizeof(unsigned int) * (wordCount + 1));
+	length = (unsigned char *)malloc(wordCount + 1);
+	histogram = aligned_alloc(16, HISTOGRAM_WIDTH * ((size_t)wordCount + 1));
+	if (dictionary == NULL || offset == NULL || mask == NULL || length == NULL || histogram == NULL){
+		LOG(LOG_ERROR, "event=dictionary_alloc_error path=%s words=%d", path, wordCount);
+		free(dictionary);
+		free(offset);
+		free(mask);
+		free(length);
+		free(histogram);
+		munmap((void *)bytes, fileStat.st_size);
+		return NULL;
+	}
+	for (int i = 0; i < chunkCount; i++){
+		chunk[i].bytes = bytes;
+		chunk[i].offset = offset;
+		chunk[i].length = length;
+		chunk[i].histogram = histogram;
+		chunk[i].mask = mask;
+	}
+	runChunks(chunk, chunkCount, indexChunkWords);
+	LOG(LOG_DEBUG, "event=dictionary_indexed path=%s words=%d threads=%d bytes=%lld", path, wordCount, chunkCount,
+		(long long)fileStat.st_size);
+
+	dictionary->wordCount = wordCount;
+	dictionary->bytes = bytes;
+	dictionary->offset = offset;
+	dictionary->length = length;
+	dictionary->histogram = (const unsigned char (*)[HISTOGRAM_WIDTH])histogram;
+	dictionary->mask = mask;
+	dictionary->master = NULL;
+	dictionary->masterCount = 0;
+	dictionary->isEmbedded = 0;
+	dictionary->mappedLength = fileStat.st_size;
+	atomic_init(&dictionary->refCount, 1);
+	return dictionary;
+}
+/*
+ * embeddedDictionary - Returns the tables compiled into the binary.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  struct dictionary* - The built-in dictionary, or NULL when the build has none.
+ */
+struct dictionary *embeddedDictionary(){
+#ifdef WWF_EMBED_DICTIONARY
+	return &embeddedTables;
+#else
+	return NULL;
+#endif
+}
+/*
+ * freeDictionary - Frees a dictionary returned by loadDictionary. The built-in one is left alone.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - The dictionary to free (may be NULL).
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void freeDictionary(struct dictionary *dictionary){
+	if (dictionary == NULL || dictionary->isEmbedded){
+		return;
+	}
+	munmap((void *)dictionary->bytes, dictionary->mappedLength);
+	free((void *)dictionary->offset);
+	free((void *)dictionary->length);
+	free((void *)dictionary->histogram);
+	free((void *)dictionary->mask);
+	free((void *)dictionary->master);
+	free(dictionary);
+}
+/*
+ * acquireDictionary - Takes a reference on the current dictionary, so a reload cannot
+ *                     free it while it is in use.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  struct dictionary* - The current dictionary; hand it back with releaseDictionary.
+ */
+struct dictionary *acquireDictionary(){
+	struct dictionary *dictionary;
+
+	pthread_mutex_lock(&dictionaryLock);
+	dictionary = wordDictionary;
+	if (dictionary != NULL){
+		atomic_fetch_add(&dictionary->refCount, 1);
+	}
+	pthread_mutex_unlock(&dictionaryLock);
+	return dictionary;
+}
+/*
+ * releaseDictionary - Drops a reference on a dictionary and frees it after the last one.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - The dictionary to release (may be NULL).
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void releaseDictionary(struct dictionary *dictionary){
+	if (dictionary != NULL && atomic_fetch_sub(&dictionary->refCount, 1) == 1){
+		freeDictionary(dictionary);
+	}
+}
+/*
+ * swapDictionary - Publishes a freshly loaded dictionary in place of the current one. The
+ *                  old one lives on until the puzzles built from it are released.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - The new dictionary, its owner reference moves to wordDictionary.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void swapDictionary(struct dictionary *dictionary){
+	struct dictionary *previous;
+
+	pthread_mutex_lock(&dictionaryLock);
+	previous = wordDictionary;
+	wordDictionary = dictionary;
+	pthread_mutex_unlock(&dictionaryLock);
+	releaseDictionary(previous);
+}
+/*
+ * letterHistogram - Counts the letters of a word, upper and lower case alike, into a
+ *                   HISTOGRAM_WIDTH row (the padding after 'z' stays zero).
+ *
+ * Parameters:
+ *  const char *word - The word.
+ *  int length - Number of characters of word to count.
+ *  unsigned char *histogram - Receives the counts.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void letterHistogram(const char *word, int length, unsigned char *histogram){
+	memset(histogram, 0, HISTOGRAM_WIDTH);
+	for (int i = 0; i < length; i++){
+		if (word[i] >= 'a' && word[i] <= 'z'){
+			histogram[word[i] - 'a']++;
+		}
+		else if (word[i] >= 'A' && word[i] <= 'Z'){
+			histogram[word[i] - 'A']++;
+		}
+	}
+}
+/*
+ * letterMask - Bit n is set when letter n occurs in the histogram.
+ *
+ * Parameters:
+ *  const unsigned char *histogram - Letter counts of a word.
+ *
+ * Return:
+ *  unsigned int - The letter mask.
+ */
+unsigned int letterMask(const unsigned char *histogram){
+	unsigned int mask = 0;
+
+	for (int i = 0; i < 26; i++){
+		if (histogram[i] != 0){
+			mask |= 1u << i;
+		}
+	}
+	return mask;
+}
+/*
+ * canFormWord - Checks whether a word can be spelled with the available letters, i.e. no
+ *               letter count of wanted exceeds the one in available. With SSE2 both
+ *               32 byte rows are compared with two saturating subtractions.
+ *
+ * Parameters:
+ *  const unsigned char *available - Histogram row of the letters at hand.
+ *  const unsigned char *wanted - Histogram row of the word.
+ *
+ * Return:
+ *  int - 1 if the word can be formed, otherwise 0.
+ */
+int canFormWord(const unsigned char *available, const unsigned char *wanted){
+#ifdef __SSE2__
+	// wanted - available saturates to 0 wherever there are enough letters
+	__m128i low = _mm_subs_epu8(_mm_loadu_si128((const __m128i *)wanted), _mm_loadu_si128((const __m128i *)available));
+	__m128i high = _mm_subs_epu8(_mm_loadu_si128((const __m128i *)(wanted + 16)),
+		_mm_loadu_si128((const __m128i *)(available + 16)));
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(low, high), _mm_setzero_si128())) == 0xFFFF;
+#else
+	for (int i = 0; i < 26; i++){
+		if (wanted[i] > available[i]){
+			return 0;
+		}
+	}
+	return 1;
+#endif
+}
+/*
+ * findFormableWords - Collects every dictionary word that can be spelled with the letters
+ *                     of word, in dictionary order. Words longer than word, or using a letter
+ *                     word does not have, are rejected on length and mask before the
+ *                     histograms are compared.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - The dictionary to scan.
+ *  const char *word - The master word.
+ *  int *matches - Receives the indexes of the matching words (room for wordCount entries).
+ *
+ * Return:
+ *  int - The number of matches.
+ */
+int findFormableWords(struct dictionary *dictionary, const char *word, int *matches){
+	_Alignas(16) unsigned char available[HISTOGRAM_WIDTH];
+	int wordLength = strlen(word), matchCount = 0;
+	unsigned int missing;
+
+	letterHistogram(word, wordLength, available);
+	missing = ~letterMask(available);
+	for (int i = 0; i < dictionary->wordCount; i++){
+		if (dictionary->length[i] > wordLength || (dictionary->mask[i] & missing) != 0){
+			continue;
+		}
+		if (canFormWord(available, dictionary->histogram[i])){
+			matches[matchCount++] = i;
+		}
+	}
+	return matchCount;
+}
+/*
+ * candidateHistogram - Counts the letters of a candidate word for validateWords, giving up as
+ *                      soon as it cannot be formed: a character that is not a letter, a letter
+ *                      the rack does not have, or more letters than the rack holds.
+ *
+ * Parameters:
+ *  const char *word - NUL-terminated candidate word.
+ *  int maxLength - Letters in the rack.
+ *  unsigned int missing - Letter mask of the letters the rack does not have.
+ *  unsigned char *histogram - Receives the counts (only complete if 1 is returned).
+ *
+ * Return:
+ *  int - 1 if the word is left to the histogram comparison, 0 if it is already rejected.
+ */
+int candidateHistogram(const char *word, int maxLength, unsigned int missing, unsigned char *histogram){
+	int length = 0, letter;
+
+	memset(histogram, 0, HISTOGRAM_WIDTH);
+	for (; word[length] != '\0'; length++){
+		if (word[length] >= 'a' && word[length] <= 'z'){
+			letter = word[length] - 'a';
+		}
+		else if (word[length] >= 'A' && word[length] <= 'Z'){
+			letter = word[length] - 'A';
+		}
+		else{
+			return 0;
+		}
+		if (length == maxLength || ((missing >> letter) & 1) != 0){
+			return 0;
+		}
+		histogram[letter]++;
+	}
+	return length > 0;
+}
+/*
+ * validateWords - Checks which candidate words can be spelled with the letters of a rack
+ *                 (each rack letter used at most once, upper and lower case alike). Works
+ *                 through the candidates VALIDATE_BLOCK at a time: their histogram rows are
+ *                 built into a buffer on the stack, rejecting on length and letters early,
+ *                 then the remaining rows go through canFormWord. Needs no dictionary.
+ *
+ * Parameters:
+ *  const char *rack - The letters at hand, only the first MAX_RACK_LENGTH characters count.
+ *  const char **words - NUL-terminated candidate words.
+ *  int count - Number of candidates.
+ *  unsigned char *results - Receives 1 for every candidate that can be formed, otherwise 0.
+ *
+ * Return:
+ *  int - The number of candidates that can be formed.
+ */
+int validateWords(const char *rack, const char **words, int count, unsigned char *results){
+	_Alignas(16) unsigned char available[HISTOGRAM_WIDTH];
+	_Alignas(16) unsigned char histogram[VALIDATE_BLOCK][HISTOGRAM_WIDTH];
+	int rackLength = strlen(rack), formable = 0;
+	unsigned int missing;
+
+	if (rackLength > MAX_RACK_LENGTH){
+		rackLength = MAX_RACK_LENGTH;
+	}
+	letterHistogram(rack, rackLength, available);
+	missing = ~letterMask(available);
+	for (int first = 0; first < count; first += VALIDATE_BLOCK){
+		int blockCount = count - first < VALIDATE_BLOCK ? count - first : VALIDATE_BLOCK;
+
+		for (int i = 0; i < blockCount; i++){
+			results[first + i] = candidateHistogram(words[first + i], rackLength, missing, histogram[i]);
+		}
+		for (int i = 0; i < blockCount; i++){
+			if (results[first + i] == 1){
+				results[first + i] = canFormWord(available, histogram[i]);
+				formable += results[first + i];
+			}
+		}
+	}
+	return formable;
+}
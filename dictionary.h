@@ -0,0 +1,67 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Flat, read-only dictionary tables: the word bytes with every word's offset, length,
+ *              letter histogram and letter mask. Loaded at runtime from a word list file, or compiled
+ *              into the binary as static tables by the WWF_EMBED_DICTIONARY build step
+ *              (tools/embedDictionary.c), in which case startup does no file I/O and no parsing.
+ *              Runtime loading maps the file and indexes it on all cores, words stay in the mapping.
+ */
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+//Longest word kept, game list nodes hold 30 characters with the terminator
+#define MAX_WORD_LENGTH 29
+//Histogram row: 26 letter counts padded to two 16 byte vectors
+#define HISTOGRAM_WIDTH 32
+//Candidate words validateWords checks per pass, their histogram rows share one stack buffer
+#define VALIDATE_BLOCK 256
+//Longest rack validateWords takes, letter counts are bytes
+#define MAX_RACK_LENGTH 255
+
+struct masterStats;
+
+//Dictionary Structure. Words are not NUL-terminated in bytes, always go through length.
+struct dictionary{
+	int wordCount;
+	const char *bytes;
+	const unsigned int *offset;
+	const unsigned char *length;
+	const unsigned char (*histogram)[HISTOGRAM_WIDTH];
+	const unsigned int *mask;
+	//Puzzle statistics index (puzzleIndex.h), empty until buildPuzzleIndex ran
+	const struct masterStats *master;
+	int masterCount;
+	//1 for the compiled-in tables, which are never freed
+	int isEmbedded;
+	//Length of the file mapping bytes points into (loaded dictionaries)
+	size_t mappedLength;
+	//References held by wordDictionary and by puzzles built from it, freed after the last one
+	atomic_int refCount;
+};
+
+//Start of word index in the dictionary bytes
+#define dictionaryWord(dictionary, index) ((dictionary)->bytes + (dictionary)->offset[index])
+
+//function prototype
+struct dictionary *loadDictionary(const char *path);
+const char *findNewline(const char *start, const char *end);
+struct dictionary *embeddedDictionary();
+void freeDictionary(struct dictionary *dictionary);
+struct dictionary *acquireDictionary();
+void releaseDictionary(struct dictionary *dictionary);
+void swapDictionary(struct dictionary *dictionary);
+void letterHistogram(const char *word, int length, unsigned char *histogram);
+unsigned int letterMask(const unsigned char *histogram);
+int canFormWord(const unsigned char *available, const unsigned char *wanted);
+int findFormableWords(struct dictionary *dictionary, const char *word, int *matches);
+int validateWords(const char *rack, const char **words, int count, unsigned char *results);
+
+//Global variable
+//Dictionary new puzzles are built from, set up by initialization and replaced by
+//swapDictionary. Threads that may run during a reload go through acquireDictionary.
+extern struct dictionary *wordDictionary;
+
+#endif
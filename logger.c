@@ -0,0 +1,207 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Asynchronous structured logger, see logger.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include "logger.h"
+
+//Global variable
+int logLevel = LOG_INFO;
+const char *logLevelName[] = {"debug", "info", "warn", "error", "off"};
+//Every thread's log ring; rings are only ever added, and recycled between threads
+_Atomic(struct logRing *) logRings = NULL;
+_Thread_local struct logRing *threadLogRing = NULL;
+pthread_key_t logRingKey;
+_Thread_local unsigned long logRequestId = 0;
+//Rings have one consumer at a time: the log writer, or a thread flushing on its way out
+pthread_mutex_t logDrainLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Function: initLogging
+ * ---------------------
+ * Reads the log level from WWF_LOG_LEVEL (debug, info, warn, error, off),
+ * starts the background log writer thread and has the process flush the
+ * rings when it exits.
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void initLogging(){
+	pthread_t writerId;
+	char *level = getenv("WWF_LOG_LEVEL");
+
+	if (level != NULL){
+		for (int i = LOG_DEBUG; i <= LOG_OFF; i++){
+			if (strcasecmp(level, logLevelName[i]) == 0){
+				logLevel = i;
+			}
+		}
+	}
+	// Rings go back to the pool when their thread exits
+	pthread_key_create(&logRingKey, releaseLogRing);
+	pthread_create(&writerId, NULL, logWriter, NULL);
+	pthread_detach(writerId);
+	// Records queued right before a return from main or exit() still get out
+	atexit(logFlush);
+}
+/*
+ * Function: releaseLogRing
+ * ------------------------
+ * Thread exit hook handing the thread's log ring back for reuse. Records that are
+ * still queued stay in the ring and are drained as usual.
+ *
+ * Parameters:
+ *      value - the ring owned by the exiting thread
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void releaseLogRing(void *value){
+	struct logRing *ring = (struct logRing *)value;
+	atomic_store_explicit(&ring->isOwned, 0, memory_order_release);
+}
+/*
+ * Function: logWrite
+ * ------------------
+ * Formats one structured (key=value) record into the calling thread's ring. Never
+ * blocks and never takes a lock: a full ring drops the record and counts it.
+ * Use the LOG macro rather than calling this directly.
+ *
+ * Parameters:
+ *      level  - LOG_DEBUG, LOG_INFO, LOG_WARN or LOG_ERROR
+ *      format - printf style format of the record's fields
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void logWrite(int level, const char *format, ...){
+	struct logRing *ring = threadLogRing;
+	struct logRecord *record;
+	unsigned int head;
+	size_t length = 0;
+	va_list args;
+
+	// First record of this thread: adopt a released ring, or add a new one
+	if (ring == NULL){
+		int unowned = 0;
+		for (ring = atomic_load(&logRings); ring; ring = ring->next){
+			if (atomic_compare_exchange_strong(&ring->isOwned, &unowned, 1)){
+				break;
+			}
+			unowned = 0;
+		}
+		if (ring == NULL){
+			ring = (struct logRing *)calloc(1, sizeof(struct logRing));
+			if (ring == NULL){
+				return;
+			}
+			atomic_init(&ring->isOwned, 1);
+			ring->next = atomic_load(&logRings);
+			while (!atomic_compare_exchange_weak(&logRings, &ring->next, ring)){
+			}
+		}
+		threadLogRing = ring;
+		pthread_setspecific(logRingKey, ring);
+	}
+
+	head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+	if (head - atomic_load_explicit(&ring->tail, memory_order_acquire) >= 256){
+		atomic_fetch_add_explicit(&ring->dropped, 1, memory_order_relaxed);
+		return;
+	}
+	record = &ring->record[head % 256];
+	clock_gettime(CLOCK_REALTIME, &record->time);
+	record->level = level;
+	if (logRequestId != 0){
+		length = snprintf(record->text, sizeof(record->text), "req=%lu ", logRequestId);
+	}
+	va_start(args, format);
+	vsnprintf(record->text + length, sizeof(record->text) - length, format, args);
+	va_end(args);
+	atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+}
+/*
+ * Function: drainLogRings
+ * -----------------------
+ * Writes every queued record of every ring to stdout, oldest first within a
+ * ring. The caller holds logDrainLock.
+ *
+ * Return:
+ *      int - 1 if anything was written, 0 if the rings were empty.
+ */
+int drainLogRings(){
+	struct logRecord *record;
+	struct tm calendar;
+	char timestamp[32];
+	unsigned int tail, head;
+	unsigned long dropped;
+	int written = 0;
+
+	for (struct logRing *ring = atomic_load(&logRings); ring; ring = ring->next){
+		head = atomic_load_explicit(&ring->head, memory_order_acquire);
+		for (tail = atomic_load_explicit(&ring->tail, memory_order_relaxed); tail != head; tail++){
+			record = &ring->record[tail % 256];
+			gmtime_r(&record->time.tv_sec, &calendar);
+			strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%S", &calendar);
+			printf("ts=%s.%03ldZ level=%s %s\n", timestamp, record->time.tv_nsec / 1000000,
+				logLevelName[record->level], record->text);
+			atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+			written = 1;
+		}
+		dropped = atomic_exchange_explicit(&ring->dropped, 0, memory_order_relaxed);
+		if (dropped > 0){
+			printf("level=warn event=log_dropped records=%lu\n", dropped);
+			written = 1;
+		}
+	}
+	return written;
+}
+/*
+ * Function: logFlush
+ * ------------------
+ * Drains every log ring on the calling thread and flushes stdout, so records
+ * logged just before the process exits are not lost with the writer thread.
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void logFlush(){
+	pthread_mutex_lock(&logDrainLock);
+	drainLogRings();
+	fflush(stdout);
+	pthread_mutex_unlock(&logDrainLock);
+}
+/*
+ * Function: logWriter
+ * -------------------
+ * Background thread draining every log ring to stdout. It is the only thread that
+ * touches the console while the process runs, and it formats the timestamp so
+ * request threads don't.
+ *
+ * Parameters:
+ *      value - unused
+ *
+ * Return:
+ *      void* - Never returns.
+ */
+void *logWriter(void *value){
+	struct timespec idle = {0, 5000000};
+	int written;
+
+	while (1){
+		pthread_mutex_lock(&logDrainLock);
+		written = drainLogRings();
+		if (written){
+			fflush(stdout);
+		}
+		pthread_mutex_unlock(&logDrainLock);
+		if (!written){
+			nanosleep(&idle, NULL);
+		}
+	}
+	return NULL;
+}
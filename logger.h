@@ -0,0 +1,54 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Asynchronous structured logger. Every thread formats key=value records into its own
+ *              single-producer ring and a background writer thread drains all rings to stdout,
+ *              so request threads never block on console I/O. logFlush drains the rings on the
+ *              calling thread; it runs at exit so the last records before exiting are kept.
+ */
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+//Log ring Structure, a single-producer ring owned by one thread at a time and
+//drained by the log writer thread
+struct logRecord{
+	struct timespec time;
+	int level;
+	char text[232];
+};
+struct logRing{
+	struct logRecord record[256];
+	atomic_uint head;
+	atomic_uint tail;
+	atomic_int isOwned;
+	atomic_ulong dropped;
+	struct logRing *next;
+};
+
+//Log levels; a record is only formatted (and its arguments only evaluated) when
+//its level is enabled, so disabled logging costs one comparison
+#define LOG_DEBUG 0
+#define LOG_INFO 1
+#define LOG_WARN 2
+#define LOG_ERROR 3
+#define LOG_OFF 4
+#define LOG(level, ...) do { if ((level) >= logLevel) logWrite((level), __VA_ARGS__); } while (0)
+
+//function prototype
+void logWrite(int level, const char *format, ...);
+void *logWriter(void *value);
+int drainLogRings();
+void logFlush();
+void releaseLogRing(void *value);
+void initLogging();
+
+//Global variable
+extern int logLevel;
+extern const char *logLevelName[];
+//Request id of the request the current thread is serving, attached to its log records
+extern _Thread_local unsigned long logRequestId;
+
+#endif
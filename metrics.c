@@ -0,0 +1,185 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Stage timers and latency histograms, see metrics.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <time.h>
+#include "metrics.h"
+
+//Global variable
+const char *stageName[] = {"recv_parse", "accept_input", "render_word", "render_board", "send", "random_word", "find_words", "compress", "validate"};
+struct latencyHistogram stageHistogram[STAGE_COUNT];
+
+/*
+ * Function: nowNanoseconds
+ * ------------------------
+ * Reads the monotonic clock (a vDSO call, no syscall) for stage timers.
+ *
+ * Return:
+ *      unsigned long long - Current monotonic time in nanoseconds.
+ */
+unsigned long long nowNanoseconds(){
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+/*
+ * Function: observeLatency
+ * ------------------------
+ * Adds the time elapsed since start to a histogram. Bucket 0 holds everything
+ * under 64ns, then each power of two is split into four linear sub-buckets;
+ * the last bucket catches overflow.
+ *
+ * Parameters:
+ *      histogram - histogram to update
+ *      start     - nowNanoseconds() when the timed stage began
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void observeLatency(struct latencyHistogram *histogram, unsigned long long start){
+	unsigned long long elapsed = nowNanoseconds() - start;
+	int index = 0;
+
+	if (elapsed >= 64){
+		int exponent = 63 - __builtin_clzll(elapsed);
+		index = (exponent - 6) * 4 + (int)((elapsed >> (exponent - 2)) & 3) + 1;
+		if (index > 121){
+			index = 121;
+		}
+	}
+	atomic_fetch_add_explicit(&histogram->bucket[index], 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&histogram->count, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&histogram->sum, elapsed, memory_order_relaxed);
+}
+/*
+ * Function: appendText
+ * --------------------
+ * printf-style append to a growing heap buffer.
+ *
+ * Parameters:
+ *      text   - buffer to append to, reallocated as needed (NULL after a failure)
+ *      length - current text length
+ *      size   - current buffer size
+ *      format - printf style format
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void appendText(char **text, size_t *length, size_t *size, const char *format, ...){
+	va_list args;
+	int needed;
+
+	if (*text == NULL){
+		return;
+	}
+	va_start(args, format);
+	needed = vsnprintf(*text + *length, *size - *length, format, args);
+	va_end(args);
+	if (*length + needed >= *size){
+		char *grown = (char *)realloc(*text, (*size + needed) * 2);
+		if (grown == NULL){
+			free(*text);
+			*text = NULL;
+			return;
+		}
+		*text = grown;
+		*size = (*size + needed) * 2;
+		va_start(args, format);
+		vsnprintf(*text + *length, *size - *length, format, args);
+		va_end(args);
+	}
+	*length += needed;
+}
+/*
+ * Function: appendJsonString
+ * --------------------------
+ * Appends a value as a quoted JSON string, escaping '"', '\' and control
+ * characters.
+ *
+ * Parameters:
+ *      text, length, size - output buffer (see appendText)
+ *      value              - characters to append
+ *      valueLength        - number of characters in value
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void appendJsonString(char **text, size_t *length, size_t *size, const char *value, size_t valueLength){
+	if (*text == NULL){
+		return;
+	}
+	// Worst case every character becomes a six byte \u00XX escape
+	if (*length + valueLength * 6 + 3 > *size){
+		size_t grownSize = (*length + valueLength * 6 + 3) * 2;
+		char *grown = (char *)realloc(*text, grownSize);
+		if (grown == NULL){
+			free(*text);
+			*text = NULL;
+			return;
+		}
+		*text = grown;
+		*size = grownSize;
+	}
+	(*text)[(*length)++] = '"';
+	for (size_t i = 0; i < valueLength; i++){
+		unsigned char c = (unsigned char)value[i];
+		if (c == '"' || c == '\\'){
+			(*text)[(*length)++] = '\\';
+			(*text)[(*length)++] = (char)c;
+		}
+		else if (c < 0x20){
+			*length += snprintf(*text + *length, *size - *length, "\\u%04x", c);
+		}
+		else{
+			(*text)[(*length)++] = (char)c;
+		}
+	}
+	(*text)[(*length)++] = '"';
+	(*text)[*length] = '\0';
+}
+/*
+ * Function: appendHistogram
+ * -------------------------
+ * Appends one histogram in Prometheus text format. Buckets are cumulative and
+ * stop at the highest non-empty one; le bounds are in seconds.
+ *
+ * Parameters:
+ *      text, length, size - output buffer (see appendText)
+ *      name               - metric name
+ *      label              - extra label pair such as stage="send", or "" for none
+ *      histogram          - histogram to export
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void appendHistogram(char **text, size_t *length, size_t *size, const char *name, const char *label, struct latencyHistogram *histogram){
+	unsigned long counts[122];
+	unsigned long cumulative = 0;
+	unsigned long long upperBound;
+	int last = -1;
+
+	for (int i = 0; i < 122; i++){
+		counts[i] = atomic_load_explicit(&histogram->bucket[i], memory_order_relaxed);
+		if (counts[i] != 0 && i < 121){
+			last = i;
+		}
+	}
+	for (int i = 0; i <= last; i++){
+		cumulative += counts[i];
+		// upper bound of bucket i: 64ns for bucket 0, else (5 + sub) << (exponent - 2)
+		upperBound = i == 0 ? 64 : (unsigned long long)(5 + (i - 1) % 4) << ((i - 1) / 4 + 4);
+		appendText(text, length, size, "%s_bucket{%s%sle=\"%.9g\"} %lu\n", name, label, label[0] ? "," : "",
+			upperBound / 1e9, cumulative);
+	}
+	cumulative += counts[121];
+	for (int i = last + 1; i < 121; i++){
+		cumulative += counts[i];
+	}
+	appendText(text, length, size, "%s_bucket{%s%sle=\"+Inf\"} %lu\n", name, label, label[0] ? "," : "", cumulative);
+	appendText(text, length, size, "%s_sum%s%s%s %.9f\n", name, label[0] ? "{" : "", label, label[0] ? "}" : "",
+		atomic_load_explicit(&histogram->sum, memory_order_relaxed) / 1e9);
+	appendText(text, length, size, "%s_count%s%s%s %lu\n", name, label[0] ? "{" : "", label, label[0] ? "}" : "", cumulative);
+}
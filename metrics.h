@@ -0,0 +1,43 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Low-overhead stage timers and lock-free latency histograms, rendered in
+ *              Prometheus text format by the server's /metrics endpoint.
+ */
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+//Latency histogram Structure, HDR-style log-linear buckets: four sub-buckets per
+//power of two nanoseconds, from 64ns to ~68s. Updated with relaxed atomic adds only.
+struct latencyHistogram{
+	atomic_ulong bucket[122];
+	atomic_ulong count;
+	atomic_ulong sum;
+};
+
+//Request and puzzle generation stages timed for /metrics
+#define STAGE_RECV_PARSE 0
+#define STAGE_ACCEPT_INPUT 1
+#define STAGE_RENDER_WORD 2
+#define STAGE_RENDER_BOARD 3
+#define STAGE_SEND 4
+#define STAGE_RANDOM_WORD 5
+#define STAGE_FIND_WORDS 6
+#define STAGE_COMPRESS 7
+#define STAGE_VALIDATE 8
+#define STAGE_COUNT 9
+
+//function prototype
+unsigned long long nowNanoseconds();
+void observeLatency(struct latencyHistogram *histogram, unsigned long long start);
+void appendText(char **text, size_t *length, size_t *size, const char *format, ...);
+void appendJsonString(char **text, size_t *length, size_t *size, const char *value, size_t valueLength);
+void appendHistogram(char **text, size_t *length, size_t *size, const char *name, const char *label, struct latencyHistogram *histogram);
+
+//Global variable
+extern const char *stageName[];
+extern struct latencyHistogram stageHistogram[STAGE_COUNT];
+
+#endif
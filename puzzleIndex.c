@@ -0,0 +1,354 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Puzzle statistics index, see puzzleIndex.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "puzzleIndex.h"
+#include "logger.h"
+
+//Most threads used to index one dictionary
+#define MAX_INDEX_THREADS 64
+
+//Dictionary word keyed by its letters in alphabetical order (anagrams share a key)
+struct keyRef{
+	unsigned char key[MAX_WORD_LENGTH];
+	int keyLength;
+	int word;
+};
+//Letter trie node over the sorted keys. Children are chained in letter order; the words
+//whose key ends here are keyRef[wordStart .. wordStart + wordCount - 1].
+struct trieNode{
+	int firstChild;
+	int lastChild;
+	int nextSibling;
+	int wordStart;
+	int wordCount;
+	unsigned char letter;
+};
+//Indexer thread Structure, one range of master words
+struct indexRange{
+	pthread_t id;
+	int isThreaded;
+	int first;
+	int last;
+	struct dictionary *dictionary;
+	struct keyRef *keyRef;
+	struct trieNode *trie;
+	struct masterStats *stats;
+};
+
+//function prototype
+int compareKeyRef(const void *a, const void *b);
+int compareMasterStats(const void *a, const void *b);
+void addBoardWords(struct indexRange *range, struct trieNode *node, struct masterStats *stats);
+void walkTrie(struct indexRange *range, int node, unsigned char *available, struct masterStats *stats);
+void *indexMasterRange(void *value);
+
+/*
+ * boardBytesOfWord - Bytes one board word takes in displayGameList, found or not.
+ *
+ * Parameters:
+ *  int length - Length of the word.
+ *
+ * Return:
+ *  int - The larger of "<p>_ _ ...</p>\n" and "<p>Found:word</p>\n".
+ */
+int boardBytesOfWord(int length){
+	return 8 + 2 * length > 14 + length ? 8 + 2 * length : 14 + length;
+}
+/*
+ * compareKeyRef - qsort comparator ordering words by key, then by dictionary index.
+ */
+int compareKeyRef(const void *a, const void *b){
+	const struct keyRef *left = (const struct keyRef *)a, *right = (const struct keyRef *)b;
+	int shorter = left->keyLength < right->keyLength ? left->keyLength : right->keyLength;
+	int order = memcmp(left->key, right->key, shorter);
+
+	if (order != 0){
+		return order;
+	}
+	if (left->keyLength != right->keyLength){
+		return left->keyLength - right->keyLength;
+	}
+	return left->word - right->word;
+}
+/*
+ * compareMasterStats - qsort comparator ordering master words by solution count, then by
+ *                      dictionary index.
+ */
+int compareMasterStats(const void *a, const void *b){
+	const struct masterStats *left = (const struct masterStats *)a, *right = (const struct masterStats *)b;
+
+	if (left->solutionCount != right->solutionCount){
+		return left->solutionCount - right->solutionCount;
+	}
+	return left->word - right->word;
+}
+/*
+ * addBoardWords - Adds the words ending at a trie node to a master word's statistics.
+ *
+ * Parameters:
+ *  struct indexRange *range - The indexer state.
+ *  struct trieNode *node - A node whose key the master word can spell.
+ *  struct masterStats *stats - The master word's statistics.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void addBoardWords(struct indexRange *range, struct trieNode *node, struct masterStats *stats){
+	const unsigned char *length = range->dictionary->length;
+
+	for (int i = node->wordStart; i < node->wordStart + node->wordCount; i++){
+		int word = range->keyRef[i].word;
+		stats->solutionCount++;
+		stats->lengthCount[length[word]]++;
+		stats->boardBytes += boardBytesOfWord(length[word]);
+		if (word != stats->word && (stats->longestWord == -1 || length[word] > length[stats->longestWord]
+			|| (length[word] == length[stats->longestWord] && word < stats->longestWord))){
+			stats->longestWord = word;
+		}
+	}
+}
+/*
+ * walkTrie - Visits every child of a trie node whose letter is still available, i.e. every
+ *            key the master word can spell that extends the current one. Gives up once the
+ *            board has outgrown BOARD_BUFFER_SIZE, which bounds the walk on dense word lists.
+ *
+ * Parameters:
+ *  struct indexRange *range - The indexer state.
+ *  int node - The current node.
+ *  unsigned char *available - Letters of the master word not used by the current key.
+ *  struct masterStats *stats - The master word's statistics.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void walkTrie(struct indexRange *range, int node, unsigned char *available, struct masterStats *stats){
+	for (int child = range->trie[node].firstChild; child != -1; child = range->trie[child].nextSibling){
+		unsigned char letter = range->trie[child].letter;
+		// A board past the buffer is dropped anyway, stop counting
+		if (stats->boardBytes > BOARD_BUFFER_SIZE){
+			return;
+		}
+		if (available[letter] == 0){
+			continue;
+		}
+		available[letter]--;
+		addBoardWords(range, &range->trie[child], stats);
+		walkTrie(range, child, available, stats);
+		available[letter]++;
+	}
+}
+/*
+ * indexMasterRange - Indexer thread: fills the statistics of a range of master words.
+ *
+ * Parameters:
+ *  void *value - The range's struct indexRange.
+ *
+ * Return:
+ *  void* - Returns NULL.
+ */
+void *indexMasterRange(void *value){
+	struct indexRange *range = (struct indexRange *)value;
+	unsigned char available[HISTOGRAM_WIDTH];
+
+	for (int i = range->first; i < range->last; i++){
+		struct masterStats *stats = &range->stats[i];
+		memcpy(available, range->dictionary->histogram[stats->word], HISTOGRAM_WIDTH);
+		stats->longestWord = -1;
+		// The container div around the words and the terminator
+		stats->boardBytes = 30;
+		// Words without letters sit on the root, every board gets them
+		addBoardWords(range, &range->trie[0], stats);
+		walkTrie(range, 0, available, stats);
+	}
+	return NULL;
+}
+/*
+ * buildPuzzleIndex - Computes the statistics of every master word of a dictionary and stores
+ *                    them, sorted by solution count, in dictionary->master. Master words whose
+ *                    board would not fit BOARD_BUFFER_SIZE are left out.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - A loaded dictionary without an index yet.
+ *
+ * Return:
+ *  int - The number of master words indexed, 0 if there are none or the index cannot be allocated.
+ */
+int buildPuzzleIndex(struct dictionary *dictionary){
+	struct indexRange range[MAX_INDEX_THREADS];
+	struct keyRef *keyRef = (struct keyRef *)malloc(sizeof(struct keyRef) * (dictionary->wordCount + 1));
+	struct trieNode *trie;
+	struct masterStats *stats;
+	int path[MAX_WORD_LENGTH + 1], nodeCount = 1, nodeCapacity = 1024, masterCount = 0, kept = 0, rangeCount;
+	long cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (keyRef == NULL){
+		LOG(LOG_ERROR, "event=puzzle_index_alloc_error words=%d", dictionary->wordCount);
+		return 0;
+	}
+	// Every word's letters in alphabetical order
+	for (int i = 0; i < dictionary->wordCount; i++){
+		keyRef[i].word = i;
+		keyRef[i].keyLength = 0;
+		for (int letter = 0; letter < 26; letter++){
+			for (int count = 0; count < dictionary->histogram[i][letter] && keyRef[i].keyLength < MAX_WORD_LENGTH; count++){
+				keyRef[i].key[keyRef[i].keyLength++] = letter;
+			}
+		}
+		masterCount += dictionary->length[i] >= MASTER_WORD_MIN_LENGTH;
+	}
+	qsort(keyRef, dictionary->wordCount, sizeof(struct keyRef), compareKeyRef);
+
+	// Sorted keys give the trie in one pass: new nodes only hang off the previous key's path
+	trie = (struct trieNode *)malloc(sizeof(struct trieNode) * nodeCapacity);
+	if (trie == NULL){
+		LOG(LOG_ERROR, "event=puzzle_index_alloc_error words=%d", dictionary->wordCount);
+		free(keyRef);
+		return 0;
+	}
+	memset(&trie[0], 0, sizeof(struct trieNode));
+	trie[0].firstChild = trie[0].lastChild = trie[0].nextSibling = -1;
+	path[0] = 0;
+	for (int i = 0, shared = 0; i < dictionary->wordCount; i++){
+		if (i > 0){
+			for (shared = 0; shared < keyRef[i].keyLength && shared < keyRef[i - 1].keyLength
+				&& keyRef[i].key[shared] == keyRef[i - 1].key[shared]; shared++);
+		}
+		for (int depth = shared; depth < keyRef[i].keyLength; depth++){
+			if (nodeCount == nodeCapacity){
+				struct trieNode *grown = (struct trieNode *)realloc(trie, sizeof(struct trieNode) * nodeCapacity * 2);
+				if (grown == NULL){
+					LOG(LOG_ERROR, "event=puzzle_index_alloc_error words=%d trie_nodes=%d", dictionary->wordCount, nodeCount);
+					free(keyRef);
+					free(trie);
+					return 0;
+				}
+				trie = grown;
+				nodeCapacity *= 2;
+			}
+			struct trieNode *node = &trie[nodeCount];
+			node->firstChild = node->lastChild = node->nextSibling = -1;
+			node->wordStart = node->wordCount = 0;
+			node->letter = keyRef[i].key[depth];
+			if (trie[path[depth]].lastChild == -1){
+				trie[path[depth]].firstChild = nodeCount;
+			}
+			else{
+				trie[trie[path[depth]].lastChild].nextSibling = nodeCount;
+			}
+			trie[path[depth]].lastChild = nodeCount;
+			path[depth + 1] = nodeCount++;
+		}
+		// Anagrams are adjacent, they share the node
+		if (trie[path[keyRef[i].keyLength]].wordCount == 0){
+			trie[path[keyRef[i].keyLength]].wordStart = i;
+		}
+		trie[path[keyRef[i].keyLength]].wordCount++;
+	}
+
+	stats = (struct masterStats *)calloc(masterCount + 1, sizeof(struct masterStats));
+	if (stats == NULL){
+		LOG(LOG_ERROR, "event=puzzle_index_alloc_error words=%d masters=%d", dictionary->wordCount, masterCount);
+		free(keyRef);
+		free(trie);
+		return 0;
+	}
+	for (int i = 0, master = 0; i < dictionary->wordCount; i++){
+		if (dictionary->length[i] >= MASTER_WORD_MIN_LENGTH){
+			stats[master++].word = i;
+		}
+	}
+
+	// Master words split evenly over the cores, the first range on this thread
+	rangeCount = cores > 1 ? cores : 1;
+	if (rangeCount > MAX_INDEX_THREADS){
+		rangeCount = MAX_INDEX_THREADS;
+	}
+	if (rangeCount > masterCount / 256 + 1){
+		rangeCount = masterCount / 256 + 1;
+	}
+	for (int i = 0; i < rangeCount; i++){
+		range[i].first = (long long)masterCount * i / rangeCount;
+		range[i].last = (long long)masterCount * (i + 1) / rangeCount;
+		range[i].dictionary = dictionary;
+		range[i].keyRef = keyRef;
+		range[i].trie = trie;
+		range[i].stats = stats;
+		range[i].isThreaded = i > 0 && pthread_create(&range[i].id, NULL, indexMasterRange, &range[i]) == 0;
+	}
+	indexMasterRange(&range[0]);
+	for (int i = 1; i < rangeCount; i++){
+		if (range[i].isThreaded){
+			pthread_join(range[i].id, NULL);
+		}
+		else{
+			indexMasterRange(&range[i]);
+		}
+	}
+
+	// Drop the boards that would not fit, then order by solution count
+	for (int i = 0; i < masterCount; i++){
+		if (stats[i].boardBytes <= BOARD_BUFFER_SIZE){
+			stats[kept++] = stats[i];
+		}
+	}
+	qsort(stats, kept, sizeof(struct masterStats), compareMasterStats);
+	if (kept < masterCount){
+		LOG(LOG_WARN, "event=puzzle_index_oversized_boards count=%d buffer=%d", masterCount - kept, BOARD_BUFFER_SIZE);
+	}
+	LOG(LOG_DEBUG, "event=puzzle_index_built masters=%d trie_nodes=%d threads=%d", kept, nodeCount, rangeCount);
+
+	free(keyRef);
+	free(trie);
+	dictionary->master = stats;
+	dictionary->masterCount = kept;
+	return kept;
+}
+/*
+ * pickMasterWord - Picks a random master word whose board has between minSolutions and
+ *                  maxSolutions words, with two binary searches over the index.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - An indexed dictionary.
+ *  int minSolutions - Fewest words on the board.
+ *  int maxSolutions - Most words on the board.
+ *  unsigned int *seed - rand_r state.
+ *
+ * Return:
+ *  int - Dictionary index of the master word, or -1 if no master word matches.
+ */
+int pickMasterWord(struct dictionary *dictionary, int minSolutions, int maxSolutions, unsigned int *seed){
+	int low = 0, high = dictionary->masterCount, first, middle;
+
+	// First master word with at least minSolutions
+	while (low < high){
+		middle = low + (high - low) / 2;
+		if (dictionary->master[middle].solutionCount < minSolutions){
+			low = middle + 1;
+		}
+		else{
+			high = middle;
+		}
+	}
+	first = low;
+	// First master word with more than maxSolutions
+	high = dictionary->masterCount;
+	while (low < high){
+		middle = low + (high - low) / 2;
+		if (dictionary->master[middle].solutionCount <= maxSolutions){
+			low = middle + 1;
+		}
+		else{
+			high = middle;
+		}
+	}
+	if (first == low){
+		return -1;
+	}
+	return dictionary->master[first + rand_r(seed) % (low - first)].word;
+}
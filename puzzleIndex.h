@@ -0,0 +1,40 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Puzzle statistics index. For every master word (a dictionary word longer than 6
+ *              letters) it records the number of words on its board, their length distribution,
+ *              the longest of them and the size of the rendered board, sorted by solution count
+ *              so "a random master word with between min and max solutions" is two binary searches.
+ *              Built with a trie over the words' sorted letters: each master only walks the
+ *              letter combinations it can spell instead of the whole dictionary. The embedded
+ *              dictionary carries its index precomputed, loaded word lists are indexed when set up.
+ */
+#ifndef PUZZLE_INDEX_H
+#define PUZZLE_INDEX_H
+
+#include "dictionary.h"
+
+//Size of the board buffer of displayGameList, boards that would not fit are left out of the index
+#define BOARD_BUFFER_SIZE 10240
+//Only words longer than this become master words
+#define MASTER_WORD_MIN_LENGTH 7
+
+//Puzzle statistics of one master word
+struct masterStats{
+	//dictionary index of the master word
+	int word;
+	//words on its board, the master word included
+	int solutionCount;
+	//bytes displayGameList needs for the board
+	int boardBytes;
+	//dictionary index of the longest word on the board besides the master word, -1 if none
+	int longestWord;
+	//number of board words of each length
+	unsigned short lengthCount[MAX_WORD_LENGTH + 1];
+};
+
+//function prototype
+int buildPuzzleIndex(struct dictionary *dictionary);
+int pickMasterWord(struct dictionary *dictionary, int minSolutions, int maxSolutions, unsigned int *seed);
+int boardBytesOfWord(int length);
+
+#endif
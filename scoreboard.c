@@ -0,0 +1,532 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Player scores and leaderboards, see scoreboard.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scoreboard.h"
+#include "metrics.h"
+
+//Player table size, a power of two at least twice MAX_PLAYERS so probes stay short
+#define PLAYER_TABLE_SIZE 8192
+//Keys the player heaps are ordered by
+#define HEAP_POINTS 0
+#define HEAP_PUZZLE_WORDS 1
+
+//Queue slot: free for the producer claiming position p while sequence == p,
+//holding the event of position p for the consumer once sequence == p + 1
+struct scoreSlot{
+	atomic_ulong sequence;
+	struct scoreEvent event;
+};
+//Bounded multi-producer single-consumer queue, producers claim positions with a CAS on tail
+struct scoreQueue{
+	_Alignas(64) atomic_ulong tail;
+	_Alignas(64) unsigned long head;
+	struct scoreSlot slot[SCORE_QUEUE_SIZE];
+};
+//Player Score Structure, owned by the score keeper
+struct playerScore{
+	char name[MAX_PLAYER_NAME];
+	unsigned long points;
+	unsigned long words;
+	//Words found on puzzleId, the puzzle the player last scored on
+	unsigned long puzzleId;
+	unsigned long puzzleWords;
+	//Position in each player heap, -1 when not on it
+	int heapIndex[2];
+};
+//Bounded min-heap of the LEADERBOARD_SIZE best players by one key, the weakest one at the root
+struct playerHeap{
+	struct playerScore *entry[LEADERBOARD_SIZE];
+	int count;
+	int key;
+};
+//Bounded max-heap of the LEADERBOARD_SIZE fastest completions, the slowest one at the root
+struct completionHeap{
+	struct scoreEvent entry[LEADERBOARD_SIZE];
+	int count;
+};
+
+//function prototype
+struct playerScore *findPlayer(const char *name);
+unsigned long playerKey(struct playerScore *player, int key);
+void swapHeapEntries(struct playerHeap *heap, int a, int b);
+void siftPlayerUp(struct playerHeap *heap, int index);
+void siftPlayerDown(struct playerHeap *heap, int index);
+void offerPlayer(struct playerHeap *heap, struct playerScore *player);
+void offerCompletion(const struct scoreEvent *event);
+void applyScoreEvent(const struct scoreEvent *event);
+int comparePlayerPoints(const void *a, const void *b);
+int comparePlayerPuzzleWords(const void *a, const void *b);
+int compareCompletions(const void *a, const void *b);
+
+//Global variable
+struct scoreShard scoreShard[SCORE_SHARDS];
+atomic_uint scoreShardCounter = 0;
+_Thread_local int threadScoreShard = -1;
+struct scoreQueue scoreQueue;
+//Score keeper state: the players (table holds index + 1, 0 is empty) and the leaderboards
+struct playerScore *player = NULL;
+int playerCount = 0;
+int playerTable[PLAYER_TABLE_SIZE];
+struct playerHeap pointsHeap = {.key = HEAP_POINTS};
+struct playerHeap puzzleHeap = {.key = HEAP_PUZZLE_WORDS};
+struct completionHeap fastestHeap;
+//Newest puzzle seen, the one puzzleHeap ranks
+unsigned long leaderboardPuzzleId = 0;
+//Bumped by every applied batch of events
+unsigned long leaderboardVersion = 0;
+
+/*
+ * Function: initScoreboard
+ * ------------------------
+ * Prepares the event queue and the player table. Call once before any score is recorded.
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void initScoreboard(){
+	for (unsigned long i = 0; i < SCORE_QUEUE_SIZE; i++){
+		atomic_init(&scoreQueue.slot[i].sequence, i);
+	}
+	atomic_init(&scoreQueue.tail, 0);
+	scoreQueue.head = 0;
+	player = (struct playerScore *)calloc(MAX_PLAYERS, sizeof(struct playerScore));
+}
+/*
+ * Function: recordScore
+ * ---------------------
+ * Counts a score event in the calling thread's shard and queues it for the score keeper.
+ * Never blocks and never takes a lock: a full queue drops the event and counts it.
+ *
+ * Parameters:
+ *      event - event to record, copied
+ *
+ * Return:
+ *      int - 1 if the event was queued, 0 if it was dropped.
+ */
+int recordScore(const struct scoreEvent *event){
+	struct scoreShard *shard;
+	struct scoreSlot *slot;
+	unsigned long position, sequence;
+	long difference;
+
+	if (threadScoreShard == -1){
+		threadScoreShard = atomic_fetch_add_explicit(&scoreShardCounter, 1, memory_order_relaxed) % SCORE_SHARDS;
+	}
+	shard = &scoreShard[threadScoreShard];
+	if (event->kind == SCORE_WORDS){
+		atomic_fetch_add_explicit(&shard->words, event->words, memory_order_relaxed);
+		atomic_fetch_add_explicit(&shard->points, event->points, memory_order_relaxed);
+	}
+	else{
+		atomic_fetch_add_explicit(&shard->completions, 1, memory_order_relaxed);
+	}
+
+	position = atomic_load_explicit(&scoreQueue.tail, memory_order_relaxed);
+	while (1){
+		slot = &scoreQueue.slot[position & (SCORE_QUEUE_SIZE - 1)];
+		sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		difference = (long)(sequence - position);
+		if (difference == 0){
+			// The slot is free for this position, claim it (a failed CAS reloads position)
+			if (atomic_compare_exchange_weak_explicit(&scoreQueue.tail, &position, position + 1,
+					memory_order_relaxed, memory_order_relaxed)){
+				break;
+			}
+		}
+		else if (difference < 0){
+			// The consumer has not freed the slot a lap ago: full
+			atomic_fetch_add_explicit(&shard->dropped, 1, memory_order_relaxed);
+			return 0;
+		}
+		else{
+			position = atomic_load_explicit(&scoreQueue.tail, memory_order_relaxed);
+		}
+	}
+	slot->event = *event;
+	atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+	return 1;
+}
+/*
+ * Function: scoreTotals
+ * ---------------------
+ * Sums the counter shards. Safe from any thread; the result is a consistent enough
+ * picture for reporting, not a snapshot.
+ *
+ * Parameters:
+ *      totals - receives the sums
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void scoreTotals(struct scoreTotals *totals){
+	memset(totals, 0, sizeof(struct scoreTotals));
+	for (int i = 0; i < SCORE_SHARDS; i++){
+		totals->words += atomic_load_explicit(&scoreShard[i].words, memory_order_relaxed);
+		totals->points += atomic_load_explicit(&scoreShard[i].points, memory_order_relaxed);
+		totals->completions += atomic_load_explicit(&scoreShard[i].completions, memory_order_relaxed);
+		totals->dropped += atomic_load_explicit(&scoreShard[i].dropped, memory_order_relaxed);
+	}
+}
+/*
+ * Function: findPlayer
+ * --------------------
+ * Looks a player up in the player table (FNV-1a, linear probing), adding it on first sight.
+ *
+ * Parameters:
+ *      name - player name
+ *
+ * Return:
+ *      struct playerScore* - The player, or NULL if MAX_PLAYERS are tracked already.
+ */
+struct playerScore *findPlayer(const char *name){
+	unsigned int hash = 2166136261u;
+	struct playerScore *found;
+
+	for (const char *c = name; *c != '\0'; c++){
+		hash = (hash ^ (unsigned char)*c) * 16777619u;
+	}
+	for (unsigned int i = hash & (PLAYER_TABLE_SIZE - 1); ; i = (i + 1) & (PLAYER_TABLE_SIZE - 1)){
+		if (playerTable[i] == 0){
+			if (player == NULL || playerCount == MAX_PLAYERS){
+				return NULL;
+			}
+			found = &player[playerCount++];
+			snprintf(found->name, MAX_PLAYER_NAME, "%s", name);
+			found->heapIndex[HEAP_POINTS] = -1;
+			found->heapIndex[HEAP_PUZZLE_WORDS] = -1;
+			playerTable[i] = playerCount;
+			return found;
+		}
+		if (strcmp(player[playerTable[i] - 1].name, name) == 0){
+			return &player[playerTable[i] - 1];
+		}
+	}
+}
+/*
+ * Function: playerKey
+ * -------------------
+ * Value a player heap is ordered by.
+ *
+ * Parameters:
+ *      player - the player
+ *      key    - HEAP_POINTS or HEAP_PUZZLE_WORDS
+ *
+ * Return:
+ *      unsigned long - The player's points or words on the current puzzle.
+ */
+unsigned long playerKey(struct playerScore *player, int key){
+	return key == HEAP_POINTS ? player->points : player->puzzleWords;
+}
+/*
+ * Function: swapHeapEntries
+ * -------------------------
+ * Swaps two heap positions and keeps the players' heap indexes in step.
+ *
+ * Parameters:
+ *      heap - the heap
+ *      a, b - positions to swap
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void swapHeapEntries(struct playerHeap *heap, int a, int b){
+	struct playerScore *temp = heap->entry[a];
+
+	heap->entry[a] = heap->entry[b];
+	heap->entry[b] = temp;
+	heap->entry[a]->heapIndex[heap->key] = a;
+	heap->entry[b]->heapIndex[heap->key] = b;
+}
+/*
+ * Function: siftPlayerUp
+ * ----------------------
+ * Moves an entry towards the root while it is weaker than its parent.
+ *
+ * Parameters:
+ *      heap  - the heap
+ *      index - position of the entry
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void siftPlayerUp(struct playerHeap *heap, int index){
+	while (index > 0 && playerKey(heap->entry[index], heap->key) < playerKey(heap->entry[(index - 1) / 2], heap->key)){
+		swapHeapEntries(heap, index, (index - 1) / 2);
+		index = (index - 1) / 2;
+	}
+}
+/*
+ * Function: siftPlayerDown
+ * ------------------------
+ * Moves an entry away from the root while a child is weaker.
+ *
+ * Parameters:
+ *      heap  - the heap
+ *      index - position of the entry
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void siftPlayerDown(struct playerHeap *heap, int index){
+	int weakest;
+
+	while (1){
+		weakest = index;
+		for (int child = 2 * index + 1; child <= 2 * index + 2 && child < heap->count; child++){
+			if (playerKey(heap->entry[child], heap->key) < playerKey(heap->entry[weakest], heap->key)){
+				weakest = child;
+			}
+		}
+		if (weakest == index){
+			return;
+		}
+		swapHeapEntries(heap, index, weakest);
+		index = weakest;
+	}
+}
+/*
+ * Function: offerPlayer
+ * ---------------------
+ * Updates a player heap after the player's key grew: an entry already on it moves down,
+ * otherwise the player joins while there is room, or replaces the root if it now beats it.
+ * Keys only ever grow (puzzleHeap is emptied when the puzzle changes), so this keeps the
+ * exact top LEADERBOARD_SIZE in O(log LEADERBOARD_SIZE).
+ *
+ * Parameters:
+ *      heap   - the heap
+ *      player - the player whose key grew
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void offerPlayer(struct playerHeap *heap, struct playerScore *player){
+	int index = player->heapIndex[heap->key];
+
+	if (index >= 0){
+		siftPlayerDown(heap, index);
+	}
+	else if (heap->count < LEADERBOARD_SIZE){
+		heap->entry[heap->count] = player;
+		player->heapIndex[heap->key] = heap->count;
+		heap->count++;
+		siftPlayerUp(heap, heap->count - 1);
+	}
+	else if (playerKey(player, heap->key) > playerKey(heap->entry[0], heap->key)){
+		heap->entry[0]->heapIndex[heap->key] = -1;
+		heap->entry[0] = player;
+		player->heapIndex[heap->key] = 0;
+		siftPlayerDown(heap, 0);
+	}
+}
+/*
+ * Function: offerCompletion
+ * -------------------------
+ * Keeps a completion if it is among the LEADERBOARD_SIZE fastest seen.
+ *
+ * Parameters:
+ *      event - SCORE_COMPLETION event
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void offerCompletion(const struct scoreEvent *event){
+	struct completionHeap *heap = &fastestHeap;
+	struct scoreEvent temp;
+	int index, slowest;
+
+	if (heap->count < LEADERBOARD_SIZE){
+		index = heap->count++;
+		heap->entry[index] = *event;
+		while (index > 0 && heap->entry[index].elapsed > heap->entry[(index - 1) / 2].elapsed){
+			temp = heap->entry[index];
+			heap->entry[index] = heap->entry[(index - 1) / 2];
+			heap->entry[(index - 1) / 2] = temp;
+			index = (index - 1) / 2;
+		}
+		return;
+	}
+	if (event->elapsed >= heap->entry[0].elapsed){
+		return;
+	}
+	heap->entry[0] = *event;
+	for (index = 0; ; index = slowest){
+		slowest = index;
+		for (int child = 2 * index + 1; child <= 2 * index + 2 && child < heap->count; child++){
+			if (heap->entry[child].elapsed > heap->entry[slowest].elapsed){
+				slowest = child;
+			}
+		}
+		if (slowest == index){
+			return;
+		}
+		temp = heap->entry[index];
+		heap->entry[index] = heap->entry[slowest];
+		heap->entry[slowest] = temp;
+	}
+}
+/*
+ * Function: applyScoreEvent
+ * -------------------------
+ * Applies one event to the player's totals and the leaderboards.
+ *
+ * Parameters:
+ *      event - the event
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void applyScoreEvent(const struct scoreEvent *event){
+	struct playerScore *scorer;
+
+	if (event->kind == SCORE_COMPLETION){
+		offerCompletion(event);
+		return;
+	}
+	scorer = findPlayer(event->player);
+	if (scorer == NULL){
+		atomic_fetch_add_explicit(&scoreShard[0].dropped, 1, memory_order_relaxed);
+		return;
+	}
+	// A new puzzle starts its board over
+	if (event->puzzleId > leaderboardPuzzleId){
+		for (int i = 0; i < puzzleHeap.count; i++){
+			puzzleHeap.entry[i]->heapIndex[HEAP_PUZZLE_WORDS] = -1;
+		}
+		puzzleHeap.count = 0;
+		leaderboardPuzzleId = event->puzzleId;
+	}
+	if (scorer->puzzleId != event->puzzleId){
+		scorer->puzzleId = event->puzzleId;
+		scorer->puzzleWords = 0;
+	}
+	scorer->points += event->points;
+	scorer->words += event->words;
+	scorer->puzzleWords += event->words;
+	offerPlayer(&pointsHeap, scorer);
+	// Late words of a puzzle already rolled over only count towards the totals
+	if (event->puzzleId == leaderboardPuzzleId){
+		offerPlayer(&puzzleHeap, scorer);
+	}
+}
+/*
+ * Function: applyScoreEvents
+ * --------------------------
+ * Drains the event queue into the players and leaderboards. Score keeper thread only.
+ *
+ * Return:
+ *      int - Number of events applied; 0 when the queue was empty.
+ */
+int applyScoreEvents(){
+	struct scoreSlot *slot;
+	int applied = 0;
+
+	while (1){
+		slot = &scoreQueue.slot[scoreQueue.head & (SCORE_QUEUE_SIZE - 1)];
+		if (atomic_load_explicit(&slot->sequence, memory_order_acquire) != scoreQueue.head + 1){
+			break;
+		}
+		applyScoreEvent(&slot->event);
+		// Hand the slot to the producer one lap ahead
+		atomic_store_explicit(&slot->sequence, scoreQueue.head + SCORE_QUEUE_SIZE, memory_order_release);
+		scoreQueue.head++;
+		applied++;
+	}
+	if (applied > 0){
+		leaderboardVersion++;
+	}
+	return applied;
+}
+/*
+ * Function: comparePlayerPoints
+ * -----------------------------
+ * qsort comparator for leaderboard order: most points first, then by name.
+ */
+int comparePlayerPoints(const void *a, const void *b){
+	const struct playerScore *first = *(struct playerScore * const *)a, *second = *(struct playerScore * const *)b;
+
+	if (first->points != second->points){
+		return first->points > second->points ? -1 : 1;
+	}
+	return strcmp(first->name, second->name);
+}
+/*
+ * Function: comparePlayerPuzzleWords
+ * ----------------------------------
+ * qsort comparator for leaderboard order: most words on the current puzzle first, then by name.
+ */
+int comparePlayerPuzzleWords(const void *a, const void *b){
+	const struct playerScore *first = *(struct playerScore * const *)a, *second = *(struct playerScore * const *)b;
+
+	if (first->puzzleWords != second->puzzleWords){
+		return first->puzzleWords > second->puzzleWords ? -1 : 1;
+	}
+	return strcmp(first->name, second->name);
+}
+/*
+ * Function: compareCompletions
+ * ----------------------------
+ * qsort comparator for leaderboard order: fastest completion first.
+ */
+int compareCompletions(const void *a, const void *b){
+	const struct scoreEvent *first = (const struct scoreEvent *)a, *second = (const struct scoreEvent *)b;
+
+	if (first->elapsed != second->elapsed){
+		return first->elapsed < second->elapsed ? -1 : 1;
+	}
+	return first->puzzleId < second->puzzleId ? -1 : first->puzzleId > second->puzzleId;
+}
+/*
+ * Function: renderLeaderboard
+ * ---------------------------
+ * Renders the leaderboards as a JSON document: the totals, the top players by points, the
+ * top players on the current puzzle and the fastest completions. Score keeper thread only.
+ * Player names are restricted to characters that need no escaping by whoever records them.
+ *
+ * Parameters:
+ *      length - receives the document length
+ *
+ * Return:
+ *      char* - malloc'd document, or NULL if an allocation failed.
+ */
+char *renderLeaderboard(size_t *length){
+	struct playerScore *ranked[LEADERBOARD_SIZE];
+	struct scoreEvent completion[LEADERBOARD_SIZE];
+	struct scoreTotals totals;
+	size_t size = 1024;
+	char *text = (char *)malloc(size);
+
+	*length = 0;
+	if (text == NULL){
+		return NULL;
+	}
+	scoreTotals(&totals);
+	appendText(&text, length, &size, "{\"version\":%lu,\"players\":%d,\"words\":%lu,\"points\":%lu,\"completions\":%lu,"
+		"\"dropped\":%lu,\"points_leaders\":[", leaderboardVersion, playerCount, totals.words, totals.points,
+		totals.completions, totals.dropped);
+	memcpy(ranked, pointsHeap.entry, sizeof(struct playerScore *) * pointsHeap.count);
+	qsort(ranked, pointsHeap.count, sizeof(struct playerScore *), comparePlayerPoints);
+	for (int i = 0; i < pointsHeap.count; i++){
+		appendText(&text, length, &size, "%s{\"player\":\"%s\",\"points\":%lu,\"words\":%lu}", i == 0 ? "" : ",",
+			ranked[i]->name, ranked[i]->points, ranked[i]->words);
+	}
+	appendText(&text, length, &size, "],\"puzzle\":%lu,\"puzzle_leaders\":[", leaderboardPuzzleId);
+	memcpy(ranked, puzzleHeap.entry, sizeof(struct playerScore *) * puzzleHeap.count);
+	qsort(ranked, puzzleHeap.count, sizeof(struct playerScore *), comparePlayerPuzzleWords);
+	for (int i = 0; i < puzzleHeap.count; i++){
+		appendText(&text, length, &size, "%s{\"player\":\"%s\",\"words\":%lu}", i == 0 ? "" : ",",
+			ranked[i]->name, ranked[i]->puzzleWords);
+	}
+	appendText(&text, length, &size, "],\"fastest\":[");
+	memcpy(completion, fastestHeap.entry, sizeof(struct scoreEvent) * fastestHeap.count);
+	qsort(completion, fastestHeap.count, sizeof(struct scoreEvent), compareCompletions);
+	for (int i = 0; i < fastestHeap.count; i++){
+		appendText(&text, length, &size, "%s{\"puzzle\":%lu,\"player\":\"%s\",\"seconds\":%.3f}", i == 0 ? "" : ",",
+			completion[i].puzzleId, completion[i].player, completion[i].elapsed / 1e9);
+	}
+	appendText(&text, length, &size, "]}\n");
+	return text;
+}
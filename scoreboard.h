@@ -0,0 +1,66 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Player scores and leaderboards. A correct guess costs its request thread two relaxed
+ *              adds to the thread's own counter shard and one slot in a lock-free bounded event queue
+ *              (recordScore); a single score keeper thread drains the queue (applyScoreEvents), keeps
+ *              every player's totals and three bounded top-K heaps up to date incrementally: points
+ *              overall, words found on the current puzzle, and fastest completed puzzles. The shards
+ *              are only summed when read (scoreTotals). Everything but recordScore and scoreTotals
+ *              belongs to the score keeper thread. The state lives in the process: server processes
+ *              sharing a game (-m) each keep the scores of the guesses they served.
+ */
+#ifndef SCOREBOARD_H
+#define SCOREBOARD_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+
+//Counter shards; request threads pick one each, round robin
+#define SCORE_SHARDS 64
+//Event queue slots (a power of two); events that find it full are dropped and counted
+#define SCORE_QUEUE_SIZE 8192
+//Entries on each leaderboard
+#define LEADERBOARD_SIZE 10
+//Room for a player name (letters, digits, '.', '-', '_', ':')
+#define MAX_PLAYER_NAME 24
+//Players the score keeper tracks; events of players beyond that are counted as dropped
+#define MAX_PLAYERS 4096
+
+//Score event kinds
+#define SCORE_WORDS 0
+#define SCORE_COMPLETION 1
+
+//Score Event Structure, what a request thread hands to the score keeper
+struct scoreEvent{
+	int kind;
+	//SCORE_WORDS: words newly found and their points (letters)
+	int words;
+	int points;
+	unsigned long puzzleId;
+	//SCORE_COMPLETION: nanoseconds from the puzzle going up to its last word
+	unsigned long long elapsed;
+	char player[MAX_PLAYER_NAME];
+};
+//Counter shard, one cache line each so threads on different shards never share one
+struct scoreShard{
+	_Alignas(64) atomic_ulong words;
+	atomic_ulong points;
+	atomic_ulong completions;
+	atomic_ulong dropped;
+};
+//Score totals summed over the shards
+struct scoreTotals{
+	unsigned long words;
+	unsigned long points;
+	unsigned long completions;
+	unsigned long dropped;
+};
+
+//function prototype
+void initScoreboard();
+int recordScore(const struct scoreEvent *event);
+int applyScoreEvents();
+char *renderLeaderboard(size_t *length);
+void scoreTotals(struct scoreTotals *totals);
+
+#endif
@@ -0,0 +1,357 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Shared memory game state, see sharedGame.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "sharedGame.h"
+#include "logger.h"
+
+//Tries a reader makes while a board is being dealt before it gives up for this time
+#define SHARED_READ_ATTEMPTS 10000
+
+//function prototype
+int readSharedFound(struct sharedGame *game, unsigned long puzzleId, uint64_t *found);
+
+/*
+ * attachSharedGame - Opens (or creates) the shared memory segment of the given name and maps
+ *                    it. The process that creates it sets it up; the others wait until it is
+ *                    ready. A segment left by earlier runs is reused, board and all.
+ *
+ * Parameters:
+ *  const char *name - POSIX shared memory name, e.g. "/wwf".
+ *  unsigned long epoch - Start time of this process, kept if it creates the segment.
+ *
+ * Return:
+ *  struct sharedGame* - The mapped segment, or NULL if it cannot be used.
+ */
+struct sharedGame *attachSharedGame(const char *name, unsigned long epoch){
+	struct sharedGame *game;
+	pthread_mutexattr_t attributes;
+	struct stat segmentStat;
+	int file, isCreator = 1;
+
+	file = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+	if (file == -1 && errno == EEXIST){
+		file = shm_open(name, O_RDWR, 0600);
+		isCreator = 0;
+	}
+	if (file == -1){
+		LOG(LOG_ERROR, "event=shared_open_error name=%s errno=%d", name, errno);
+		return NULL;
+	}
+	if (isCreator == 1 && ftruncate(file, sizeof(struct sharedGame)) == -1){
+		LOG(LOG_ERROR, "event=shared_size_error name=%s errno=%d", name, errno);
+		close(file);
+		shm_unlink(name);
+		return NULL;
+	}
+	// The creator may not have sized it yet
+	for (int i = 0; isCreator == 0 && i < 500; i++){
+		if (fstat(file, &segmentStat) == 0 && segmentStat.st_size != 0){
+			break;
+		}
+		usleep(10000);
+	}
+	if (fstat(file, &segmentStat) == -1 || (size_t)segmentStat.st_size != sizeof(struct sharedGame)){
+		LOG(LOG_ERROR, "event=shared_rejected name=%s reason=size size=%lld", name, (long long)segmentStat.st_size);
+		close(file);
+		return NULL;
+	}
+	game = (struct sharedGame *)mmap(NULL, sizeof(struct sharedGame), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+	close(file);
+	if (game == MAP_FAILED){
+		LOG(LOG_ERROR, "event=shared_map_error name=%s errno=%d", name, errno);
+		return NULL;
+	}
+
+	if (isCreator == 1){
+		// The segment starts zeroed: no board, version 0
+		pthread_mutexattr_init(&attributes);
+		pthread_mutexattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+		pthread_mutexattr_setrobust(&attributes, PTHREAD_MUTEX_ROBUST);
+		pthread_mutex_init(&game->lock, &attributes);
+		pthread_mutexattr_destroy(&attributes);
+		memcpy(game->magic, SHARED_GAME_MAGIC, sizeof(SHARED_GAME_MAGIC));
+		game->epoch = epoch;
+		atomic_store(&game->isReady, 1);
+	}
+	for (int i = 0; atomic_load(&game->isReady) == 0 && i < 500; i++){
+		usleep(10000);
+	}
+	if (atomic_load(&game->isReady) == 0 || memcmp(game->magic, SHARED_GAME_MAGIC, sizeof(SHARED_GAME_MAGIC)) != 0){
+		LOG(LOG_ERROR, "event=shared_rejected name=%s reason=not_initialized", name);
+		munmap(game, sizeof(struct sharedGame));
+		return NULL;
+	}
+	LOG(LOG_INFO, "event=shared_attached name=%s created=%d puzzle=%lu version=%lu", name, isCreator,
+		atomic_load(&game->puzzleId), atomic_load(&game->stateVersion));
+	return game;
+}
+/*
+ * lockSharedGame - Takes the segment lock. If its last holder died, the lock is recovered;
+ *                  a board that process left half dealt is dropped (puzzle id 0) so the next
+ *                  rollover deals a whole one, and the found count of a whole one is recounted
+ *                  from its found bits.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *
+ * Return:
+ *  int - 0 once the lock is held, -1 if it cannot be taken.
+ */
+int lockSharedGame(struct sharedGame *game){
+	int result = pthread_mutex_lock(&game->lock);
+
+	if (result == EOWNERDEAD){
+		LOG(LOG_WARN, "event=shared_lock_recovered");
+		if ((atomic_load(&game->sequence) & 1) != 0){
+			atomic_store(&game->puzzleId, 0);
+			atomic_fetch_add(&game->sequence, 1);
+			atomic_fetch_add(&game->stateVersion, 1);
+		}
+		else{
+			// It may have died between setting found bits and counting them
+			int foundCount = 0;
+			for (int i = 0; i < game->wordCount && i < SHARED_MAX_WORDS; i += 64){
+				unsigned long long bits = atomic_load(&game->found[i / 64]);
+				if (game->wordCount - i < 64){
+					bits &= (1ULL << (game->wordCount - i)) - 1;
+				}
+				foundCount += __builtin_popcountll(bits);
+			}
+			if (atomic_exchange(&game->foundCount, foundCount) != foundCount){
+				atomic_fetch_add(&game->stateVersion, 1);
+			}
+		}
+		pthread_mutex_consistent(&game->lock);
+		result = 0;
+	}
+	return result == 0 ? 0 : -1;
+}
+/*
+ * dealSharedPuzzle - Puts a puzzle on the shared board, if the board is still the finished
+ *                    one (or empty). The puzzle gets the next shared id; words it already
+ *                    has found stay found.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *  struct puzzle *puzzle - Puzzle to deal, not yet seen by any request.
+ *  unsigned long finishedId - Id of the board it replaces; 0 only deals onto an empty board.
+ *
+ * Return:
+ *  int - 1 if it was dealt, 0 if another board is up already, -1 if it does not fit.
+ */
+int dealSharedPuzzle(struct sharedGame *game, struct puzzle *puzzle, unsigned long finishedId){
+	unsigned long currentId;
+	int i = 0, foundCount = 0;
+
+	if (puzzle->wordCount > SHARED_MAX_WORDS){
+		return -1;
+	}
+	if (lockSharedGame(game) == -1){
+		return 0;
+	}
+	currentId = atomic_load(&game->puzzleId);
+	if (currentId != 0 && (currentId != finishedId || atomic_load(&game->foundCount) < game->wordCount)){
+		pthread_mutex_unlock(&game->lock);
+		return 0;
+	}
+
+	// Readers retry while the sequence is odd or has moved
+	atomic_fetch_add(&game->sequence, 1);
+	puzzle->id = atomic_fetch_add(&game->puzzleCounter, 1) + 1;
+	snprintf(game->masterWord, SHARED_WORD_BYTES, "%s", puzzle->masterWord);
+	for (int j = 0; j < SHARED_MAX_WORDS / 64; j++){
+		atomic_store(&game->found[j], 0);
+	}
+	for (struct gameListNode *node = puzzle->gameRoot; node != NULL; node = node->next, i++){
+		memset(game->word[i], 0, SHARED_WORD_BYTES);
+		snprintf(game->word[i], SHARED_WORD_BYTES, "%s", node->str);
+		if (atomic_load(&node->isFound) == 1){
+			atomic_fetch_or(&game->found[i / 64], 1ULL << (i % 64));
+			foundCount++;
+		}
+	}
+	game->wordCount = i;
+	atomic_store(&game->foundCount, foundCount);
+	atomic_store(&game->puzzleId, puzzle->id);
+	atomic_fetch_add(&game->sequence, 1);
+	atomic_fetch_add(&game->stateVersion, 1);
+	pthread_mutex_unlock(&game->lock);
+	return 1;
+}
+/*
+ * adoptSharedPuzzle - Builds this process' copy of the shared board, found words included.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *
+ * Return:
+ *  struct puzzle* - The puzzle holding one reference, or NULL if there is no whole board to take.
+ */
+struct puzzle *adoptSharedPuzzle(struct sharedGame *game){
+	char (*word)[SHARED_WORD_BYTES] = (char (*)[SHARED_WORD_BYTES])malloc(sizeof(game->word));
+	char masterWord[SHARED_WORD_BYTES];
+	uint64_t found[SHARED_MAX_WORDS / 64];
+	unsigned long sequence, puzzleId = 0;
+	struct puzzle *puzzle = NULL;
+	int wordCount = 0, attempt;
+
+	if (word == NULL){
+		return NULL;
+	}
+	for (attempt = 0; attempt < SHARED_READ_ATTEMPTS; attempt++){
+		sequence = atomic_load(&game->sequence);
+		if ((sequence & 1) != 0){
+			sched_yield();
+			continue;
+		}
+		puzzleId = atomic_load(&game->puzzleId);
+		wordCount = game->wordCount;
+		if (wordCount < 0 || wordCount > SHARED_MAX_WORDS){
+			wordCount = 0;
+		}
+		memcpy(masterWord, game->masterWord, SHARED_WORD_BYTES);
+		memcpy(word, game->word, (size_t)wordCount * SHARED_WORD_BYTES);
+		for (int i = 0; i < SHARED_MAX_WORDS / 64; i++){
+			found[i] = atomic_load(&game->found[i]);
+		}
+		if (atomic_load(&game->sequence) == sequence){
+			break;
+		}
+	}
+	if (attempt < SHARED_READ_ATTEMPTS && puzzleId != 0 && wordCount > 0){
+		masterWord[SHARED_WORD_BYTES - 1] = '\0';
+		puzzle = assemblePuzzle(puzzleId, masterWord, (const char *)word, SHARED_WORD_BYTES, wordCount, found);
+	}
+	free(word);
+	return puzzle;
+}
+/*
+ * shareFoundWords - Records words this process found in the segment and bumps the shared
+ *                   state version once. Words of a board that is no longer up are ignored,
+ *                   as are words another process recorded first. Exactly one call, across
+ *                   all processes, finds the board's last word and is told so.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *  struct puzzle *puzzle - This process' copy of the board the words were found on.
+ *  struct gameListNode **words - The words.
+ *  int count - Number of words.
+ *  int *isCompleted - Set to 1 if these words completed the board, else 0.
+ *
+ * Return:
+ *  int - The number of words that were new to the segment.
+ */
+int shareFoundWords(struct sharedGame *game, struct puzzle *puzzle, struct gameListNode **words, int count, int *isCompleted){
+	unsigned long long bit, previous;
+	int i = 0, newlyFound = 0;
+
+	*isCompleted = 0;
+	if (lockSharedGame(game) == -1){
+		return 0;
+	}
+	if (atomic_load(&game->puzzleId) != puzzle->id){
+		pthread_mutex_unlock(&game->lock);
+		return 0;
+	}
+	// Word positions are the same in every copy of the board
+	for (struct gameListNode *node = puzzle->gameRoot; node != NULL && i < SHARED_MAX_WORDS; node = node->next, i++){
+		for (int j = 0; j < count; j++){
+			if (words[j] == node){
+				bit = 1ULL << (i % 64);
+				previous = atomic_fetch_or(&game->found[i / 64], bit);
+				newlyFound += (previous & bit) == 0;
+				break;
+			}
+		}
+	}
+	if (newlyFound > 0){
+		// Under the lock, only the words that take foundCount up to wordCount see it happen
+		*isCompleted = atomic_fetch_add(&game->foundCount, newlyFound) + newlyFound >= game->wordCount;
+		atomic_fetch_add(&game->stateVersion, 1);
+	}
+	pthread_mutex_unlock(&game->lock);
+	return newlyFound;
+}
+/*
+ * readSharedFound - Copies the found bitset of the shared board, if it still is the given one.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *  unsigned long puzzleId - Board the caller holds.
+ *  uint64_t *found - Receives SHARED_MAX_WORDS bits.
+ *
+ * Return:
+ *  int - 1 if the bits were copied, 0 if another board is up (or being dealt).
+ */
+int readSharedFound(struct sharedGame *game, unsigned long puzzleId, uint64_t *found){
+	unsigned long sequence;
+
+	for (int attempt = 0; attempt < SHARED_READ_ATTEMPTS; attempt++){
+		sequence = atomic_load(&game->sequence);
+		if ((sequence & 1) != 0){
+			sched_yield();
+			continue;
+		}
+		if (atomic_load(&game->puzzleId) != puzzleId){
+			return 0;
+		}
+		for (int i = 0; i < SHARED_MAX_WORDS / 64; i++){
+			found[i] = atomic_load(&game->found[i]);
+		}
+		if (atomic_load(&game->sequence) == sequence){
+			return 1;
+		}
+	}
+	return 0;
+}
+/*
+ * pullFoundWords - Marks the words other processes found on this process' copy of the board.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *  struct puzzle *puzzle - This process' copy of the shared board.
+ *  struct gameListNode **newlyFound - Receives the words newly marked (room for wordCount).
+ *
+ * Return:
+ *  int - The number of words newly marked.
+ */
+int pullFoundWords(struct sharedGame *game, struct puzzle *puzzle, struct gameListNode **newlyFound){
+	uint64_t found[SHARED_MAX_WORDS / 64];
+	int i = 0, count = 0;
+
+	if (readSharedFound(game, puzzle->id, found) == 0){
+		return 0;
+	}
+	for (struct gameListNode *node = puzzle->gameRoot; node != NULL && i < SHARED_MAX_WORDS; node = node->next, i++){
+		if (((found[i / 64] >> (i % 64)) & 1) != 0 && atomic_exchange(&node->isFound, 1) == 0){
+			newlyFound[count++] = node;
+		}
+	}
+	if (count > 0){
+		atomic_fetch_add(&puzzle->foundCount, count);
+	}
+	return count;
+}
+/*
+ * isSharedPuzzleDone - Checks whether every word of the shared board is found.
+ *
+ * Parameters:
+ *  struct sharedGame *game - The segment.
+ *  unsigned long puzzleId - Board the caller asks about.
+ *
+ * Return:
+ *  int - 1 if that board is up and complete, otherwise 0.
+ */
+int isSharedPuzzleDone(struct sharedGame *game, unsigned long puzzleId){
+	return atomic_load(&game->puzzleId) == puzzleId && atomic_load(&game->foundCount) >= game->wordCount;
+}
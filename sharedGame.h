@@ -0,0 +1,58 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Game state shared by several server processes on one host through a POSIX shared
+ *              memory segment: the board being played (puzzle id, master word, words), its found
+ *              bitset and the state version. Every process mirrors the board in its own struct puzzle
+ *              and keeps the mirror in step (pullFoundWords, adoptSharedPuzzle); words it finds go to
+ *              the segment first (shareFoundWords). Found bits are set with atomic or, new boards are
+ *              dealt under a process-shared robust mutex and read through a sequence counter, so a
+ *              reader never takes a lock and never sees half a board.
+ */
+#ifndef SHARED_GAME_H
+#define SHARED_GAME_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "wordEngine.h"
+
+#define SHARED_GAME_MAGIC "WWFSHM1"
+//Largest board the segment holds; the puzzle index never deals one that large (BOARD_BUFFER_SIZE)
+#define SHARED_MAX_WORDS 1024
+//Room for one word (gameListNode str) in the segment
+#define SHARED_WORD_BYTES 32
+
+//Shared Game Structure, the layout of the segment
+struct sharedGame{
+	char magic[8];
+	//Set by the process that created the segment once everything below is initialized
+	atomic_int isReady;
+	//Held to deal a board and to record found words
+	pthread_mutex_t lock;
+	//Odd while a board is being dealt
+	atomic_ulong sequence;
+	//Bumped on every found word and every new board, followed by every process
+	atomic_ulong stateVersion;
+	//Ids handed to dealt boards, so they are unique across processes
+	atomic_ulong puzzleCounter;
+	//Start time of the first process, shared so all processes hand out the same ETags
+	unsigned long epoch;
+	//Board being played, 0 until the first one is dealt
+	atomic_ulong puzzleId;
+	int wordCount;
+	atomic_int foundCount;
+	char masterWord[SHARED_WORD_BYTES];
+	char word[SHARED_MAX_WORDS][SHARED_WORD_BYTES];
+	atomic_ullong found[SHARED_MAX_WORDS / 64];
+};
+
+//function prototype
+struct sharedGame *attachSharedGame(const char *name, unsigned long epoch);
+int lockSharedGame(struct sharedGame *game);
+int dealSharedPuzzle(struct sharedGame *game, struct puzzle *puzzle, unsigned long finishedId);
+struct puzzle *adoptSharedPuzzle(struct sharedGame *game);
+int shareFoundWords(struct sharedGame *game, struct puzzle *puzzle, struct gameListNode **words, int count, int *isCompleted);
+int pullFoundWords(struct sharedGame *game, struct puzzle *puzzle, struct gameListNode **newlyFound);
+int isSharedPuzzleDone(struct sharedGame *game, unsigned long puzzleId);
+
+#endif
@@ -0,0 +1,297 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Game state snapshots, see snapshot.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "snapshot.h"
+#include "dictionary.h"
+#include "logger.h"
+
+//function prototype
+size_t encodePuzzle(struct puzzle *puzzle, unsigned char *record);
+struct puzzle *decodePuzzle(const unsigned char *record, size_t available, size_t *used);
+int writeFully(int file, const unsigned char *bytes, size_t length);
+int syncDirectory(const char *path);
+
+/*
+ * snapshotPuzzleBytes - Size of one puzzle record in the file.
+ *
+ * Parameters:
+ *  int wordCount - Words on the board.
+ *
+ * Return:
+ *  size_t - Bytes of the record, words and found bitset included.
+ */
+size_t snapshotPuzzleBytes(int wordCount){
+	return sizeof(struct snapshotPuzzle) + (size_t)wordCount * SNAPSHOT_WORD_BYTES
+		+ (size_t)(wordCount + 63) / 64 * sizeof(uint64_t);
+}
+/*
+ * snapshotChecksum - 64 bit FNV-1a hash, catches torn or foreign files before they are restored.
+ *
+ * Parameters:
+ *  const unsigned char *bytes - Data to hash.
+ *  size_t length - Its length in bytes.
+ *
+ * Return:
+ *  uint64_t - The hash.
+ */
+uint64_t snapshotChecksum(const unsigned char *bytes, size_t length){
+	uint64_t hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < length; i++){
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+/*
+ * encodePuzzle - Writes the record of one puzzle: its words in board order and a bit per
+ *                word that is found. Found flags are read one by one while guesses may
+ *                still land, which is fine: words only ever become found.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle, held by the caller.
+ *  unsigned char *record - Where to write, snapshotPuzzleBytes(puzzle->wordCount) bytes.
+ *
+ * Return:
+ *  size_t - Bytes written.
+ */
+size_t encodePuzzle(struct puzzle *puzzle, unsigned char *record){
+	struct snapshotPuzzle *header = (struct snapshotPuzzle *)record;
+	unsigned char *word = record + sizeof(struct snapshotPuzzle);
+	uint64_t *found = (uint64_t *)(word + (size_t)puzzle->wordCount * SNAPSHOT_WORD_BYTES);
+	int i = 0;
+
+	memset(record, 0, snapshotPuzzleBytes(puzzle->wordCount));
+	header->id = puzzle->id;
+	header->wordCount = puzzle->wordCount;
+	strncpy(header->masterWord, puzzle->masterWord, SNAPSHOT_WORD_BYTES - 1);
+	for (struct gameListNode *node = puzzle->gameRoot; node != NULL && i < puzzle->wordCount; node = node->next, i++){
+		strncpy((char *)word + (size_t)i * SNAPSHOT_WORD_BYTES, node->str, SNAPSHOT_WORD_BYTES - 1);
+		if (atomic_load(&node->isFound) == 1){
+			found[i / 64] |= 1ULL << (i % 64);
+		}
+	}
+	return snapshotPuzzleBytes(puzzle->wordCount);
+}
+/*
+ * writeFully - Writes a whole buffer, across short writes and interrupted calls.
+ *
+ * Parameters:
+ *  int file - Open file descriptor.
+ *  const unsigned char *bytes - Data to write.
+ *  size_t length - Its length in bytes.
+ *
+ * Return:
+ *  int - 0 on success, -1 if a write failed.
+ */
+int writeFully(int file, const unsigned char *bytes, size_t length){
+	while (length > 0){
+		ssize_t written = write(file, bytes, length);
+		if (written == -1){
+			if (errno == EINTR){
+				continue;
+			}
+			return -1;
+		}
+		bytes += written;
+		length -= written;
+	}
+	return 0;
+}
+/*
+ * syncDirectory - Flushes the directory entry of a file, so a rename over it survives a crash.
+ *
+ * Parameters:
+ *  const char *path - The file whose directory to sync.
+ *
+ * Return:
+ *  int - 0 on success, -1 on failure.
+ */
+int syncDirectory(const char *path){
+	char copy[4096];
+	int directory, result;
+
+	snprintf(copy, sizeof(copy), "%s", path);
+	directory = open(dirname(copy), O_RDONLY);
+	if (directory == -1){
+		return -1;
+	}
+	result = fsync(directory);
+	close(directory);
+	return result;
+}
+/*
+ * saveSnapshot - Writes the puzzles and the engine state to path: the whole image goes to
+ *                <path>.tmp, is synced to disk and then renamed over path.
+ *
+ * Parameters:
+ *  const char *path - The snapshot file.
+ *  struct puzzle **puzzles - The puzzle being played first, then the prepared one; held by the caller.
+ *  int puzzleCount - Number of puzzles, at most SNAPSHOT_MAX_PUZZLES.
+ *  unsigned long stateVersion - Game state version, read before the puzzles are encoded.
+ *
+ * Return:
+ *  int - 0 on success, -1 on failure (the previous snapshot is left in place).
+ */
+int saveSnapshot(const char *path, struct puzzle **puzzles, int puzzleCount, unsigned long stateVersion){
+	struct snapshotHeader *header;
+	unsigned char *image, *cursor;
+	size_t length = sizeof(struct snapshotHeader);
+	char temporary[4096];
+	int file;
+
+	if (puzzleCount < 1 || puzzleCount > SNAPSHOT_MAX_PUZZLES){
+		return -1;
+	}
+	for (int i = 0; i < puzzleCount; i++){
+		length += snapshotPuzzleBytes(puzzles[i]->wordCount);
+	}
+	image = (unsigned char *)calloc(1, length);
+	if (image == NULL){
+		return -1;
+	}
+	cursor = image + sizeof(struct snapshotHeader);
+	for (int i = 0; i < puzzleCount; i++){
+		cursor += encodePuzzle(puzzles[i], cursor);
+	}
+	header = (struct snapshotHeader *)image;
+	memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header->format = SNAPSHOT_FORMAT;
+	header->puzzleCount = puzzleCount;
+	header->stateVersion = stateVersion;
+	header->puzzleCounter = puzzleCounter;
+	header->randomWordSeed = randomWordSeed;
+	header->payloadLength = length - sizeof(struct snapshotHeader);
+	header->checksum = snapshotChecksum(image + sizeof(struct snapshotHeader), header->payloadLength);
+
+	snprintf(temporary, sizeof(temporary), "%s.tmp", path);
+	file = open(temporary, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	if (file == -1){
+		LOG(LOG_ERROR, "event=snapshot_open_error path=%s errno=%d", temporary, errno);
+		free(image);
+		return -1;
+	}
+	if (writeFully(file, image, length) == -1 || fsync(file) == -1){
+		LOG(LOG_ERROR, "event=snapshot_write_error path=%s errno=%d", temporary, errno);
+		close(file);
+		unlink(temporary);
+		free(image);
+		return -1;
+	}
+	close(file);
+	free(image);
+	if (rename(temporary, path) == -1){
+		LOG(LOG_ERROR, "event=snapshot_rename_error path=%s errno=%d", path, errno);
+		unlink(temporary);
+		return -1;
+	}
+	syncDirectory(path);
+	return 0;
+}
+/*
+ * decodePuzzle - Builds a puzzle back from its record, on the current dictionary.
+ *                Nothing is looked up: the board is taken as it was saved.
+ *
+ * Parameters:
+ *  const unsigned char *record - Start of the record.
+ *  size_t available - Bytes left in the file from record on.
+ *  size_t *used - Receives the size of the record.
+ *
+ * Return:
+ *  struct puzzle* - The puzzle holding one reference, or NULL if the record is damaged.
+ */
+struct puzzle *decodePuzzle(const unsigned char *record, size_t available, size_t *used){
+	const struct snapshotPuzzle *header = (const struct snapshotPuzzle *)record;
+	const unsigned char *word;
+
+	if (available < sizeof(struct snapshotPuzzle) || header->wordCount == 0 || header->wordCount > INT32_MAX / SNAPSHOT_WORD_BYTES
+		|| available < snapshotPuzzleBytes(header->wordCount) || memchr(header->masterWord, '\0', SNAPSHOT_WORD_BYTES) == NULL){
+		return NULL;
+	}
+	*used = snapshotPuzzleBytes(header->wordCount);
+	word = record + sizeof(struct snapshotPuzzle);
+	return assemblePuzzle(header->id, header->masterWord, (const char *)word, SNAPSHOT_WORD_BYTES, header->wordCount,
+		(const uint64_t *)(word + (size_t)header->wordCount * SNAPSHOT_WORD_BYTES));
+}
+/*
+ * loadSnapshot - Maps the snapshot at path and restores the puzzles in it, the puzzle id
+ *                counter and the master word picker. A missing, torn or foreign file is
+ *                rejected whole and nothing is changed.
+ *
+ * Parameters:
+ *  const char *path - The snapshot file.
+ *  struct gameSnapshot *snapshot - Receives the puzzles (one reference each) and the state version.
+ *
+ * Return:
+ *  int - 0 on success, -1 if there is no usable snapshot.
+ */
+int loadSnapshot(const char *path, struct gameSnapshot *snapshot){
+	const struct snapshotHeader *header;
+	const unsigned char *bytes;
+	struct stat fileStat;
+	size_t offset, used;
+	unsigned long highestId = 0;
+	int file;
+
+	memset(snapshot, 0, sizeof(struct gameSnapshot));
+	file = open(path, O_RDONLY);
+	if (file == -1){
+		LOG(errno == ENOENT ? LOG_INFO : LOG_ERROR, "event=snapshot_missing path=%s errno=%d", path, errno);
+		return -1;
+	}
+	if (fstat(file, &fileStat) == -1 || (size_t)fileStat.st_size < sizeof(struct snapshotHeader)){
+		LOG(LOG_ERROR, "event=snapshot_read_error path=%s", path);
+		close(file);
+		return -1;
+	}
+	bytes = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+	if (bytes == MAP_FAILED){
+		LOG(LOG_ERROR, "event=snapshot_map_error path=%s", path);
+		return -1;
+	}
+
+	header = (const struct snapshotHeader *)bytes;
+	if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || header->format != SNAPSHOT_FORMAT
+		|| header->puzzleCount < 1 || header->puzzleCount > SNAPSHOT_MAX_PUZZLES
+		|| header->payloadLength != (uint64_t)fileStat.st_size - sizeof(struct snapshotHeader)
+		|| header->checksum != snapshotChecksum(bytes + sizeof(struct snapshotHeader), header->payloadLength)){
+		LOG(LOG_ERROR, "event=snapshot_rejected path=%s reason=header_or_checksum", path);
+		munmap((void *)bytes, fileStat.st_size);
+		return -1;
+	}
+	offset = sizeof(struct snapshotHeader);
+	for (uint32_t i = 0; i < header->puzzleCount; i++){
+		snapshot->puzzle[i] = decodePuzzle(bytes + offset, fileStat.st_size - offset, &used);
+		if (snapshot->puzzle[i] == NULL){
+			LOG(LOG_ERROR, "event=snapshot_rejected path=%s reason=puzzle_record index=%u", path, i);
+			for (uint32_t j = 0; j < i; j++){
+				releasePuzzle(snapshot->puzzle[j]);
+			}
+			memset(snapshot, 0, sizeof(struct gameSnapshot));
+			munmap((void *)bytes, fileStat.st_size);
+			return -1;
+		}
+		if (snapshot->puzzle[i]->id > highestId){
+			highestId = snapshot->puzzle[i]->id;
+		}
+		offset += used;
+	}
+	snapshot->puzzleCount = header->puzzleCount;
+	snapshot->stateVersion = header->stateVersion;
+	// New puzzles keep counting from where the last run stopped, and the picker resumes its sequence
+	puzzleCounter = header->puzzleCounter > highestId ? header->puzzleCounter : highestId;
+	randomWordSeed = header->randomWordSeed;
+	munmap((void *)bytes, fileStat.st_size);
+	return 0;
+}
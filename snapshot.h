@@ -0,0 +1,59 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Binary snapshots of the live game state: the puzzles being played and prepared, which
+ *              of their words are found, the state version and the position of the master word picker.
+ *              A restarted server maps the file and picks the game up where it stopped instead of
+ *              building a new board. Snapshots are written to <path>.tmp, synced and renamed over
+ *              <path>, so a crash leaves either the previous snapshot or the new one, never half of one.
+ *              The file is in native byte order and layout, it is read back on the machine that wrote it.
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "wordEngine.h"
+
+#define SNAPSHOT_MAGIC "WWFSNAP"
+//Bumped whenever the layout below changes, older files are not restored
+#define SNAPSHOT_FORMAT 1
+//Puzzles in one snapshot: the one being played and the prepared one
+#define SNAPSHOT_MAX_PUZZLES 2
+//Room for one word (gameListNode str) in the file
+#define SNAPSHOT_WORD_BYTES 32
+
+//Snapshot file header, followed by puzzleCount puzzle records (payloadLength bytes)
+struct snapshotHeader{
+	char magic[8];
+	uint32_t format;
+	uint32_t puzzleCount;
+	uint64_t stateVersion;
+	uint64_t puzzleCounter;
+	uint32_t randomWordSeed;
+	uint32_t reserved;
+	uint64_t payloadLength;
+	//FNV-1a of the payload
+	uint64_t checksum;
+};
+//Puzzle record, followed by wordCount words of SNAPSHOT_WORD_BYTES in board order
+//and the found bitset, (wordCount + 63) / 64 words of 64 bits
+struct snapshotPuzzle{
+	uint64_t id;
+	uint32_t wordCount;
+	uint32_t reserved;
+	char masterWord[SNAPSHOT_WORD_BYTES];
+};
+//Game state read back by loadSnapshot, puzzle[0] is the one being played
+struct gameSnapshot{
+	struct puzzle *puzzle[SNAPSHOT_MAX_PUZZLES];
+	int puzzleCount;
+	unsigned long stateVersion;
+};
+
+//function prototype
+int saveSnapshot(const char *path, struct puzzle **puzzles, int puzzleCount, unsigned long stateVersion);
+int loadSnapshot(const char *path, struct gameSnapshot *snapshot);
+size_t snapshotPuzzleBytes(int wordCount);
+uint64_t snapshotChecksum(const unsigned char *bytes, size_t length);
+
+#endif
@@ -0,0 +1,204 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Hierarchical timer wheel, see timerWheel.h.
+ */
+#include <stddef.h>
+#include "timerWheel.h"
+
+//function prototype
+void placeTimer(struct timerWheel *wheel, struct wheelTimer *timer);
+void cascadeSlot(struct timerWheel *wheel, int level, int index);
+
+/*
+ * Function: initTimerWheel
+ * ------------------------
+ * Empties every slot of a wheel and starts its clock at now.
+ *
+ * Parameters:
+ *      wheel - wheel to set up
+ *      now   - nowNanoseconds() (or any monotonic nanosecond clock the caller keeps using)
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void initTimerWheel(struct timerWheel *wheel, unsigned long long now){
+	for (int level = 0; level < WHEEL_LEVELS; level++){
+		for (int i = 0; i < WHEEL_SLOTS; i++){
+			wheel->slot[level][i].next = &wheel->slot[level][i];
+			wheel->slot[level][i].prev = &wheel->slot[level][i];
+		}
+	}
+	wheel->currentTick = now / WHEEL_TICK_NANOSECONDS;
+	wheel->armedCount = 0;
+}
+
+/*
+ * Function: placeTimer
+ * --------------------
+ * Links a timer into the slot for its expiry tick: the lowest level whose span still
+ * reaches that far. Timers beyond the top level wait in its furthest slot and are
+ * placed again when it cascades.
+ *
+ * Parameters:
+ *      wheel - wheel to insert into
+ *      timer - timer with expires set, not linked anywhere
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void placeTimer(struct timerWheel *wheel, struct wheelTimer *timer){
+	unsigned long long delta = timer->expires - wheel->currentTick;
+	unsigned long long key = timer->expires;
+	struct wheelTimer *head;
+	int level = 0;
+
+	while (level < WHEEL_LEVELS - 1 && delta >= 1ULL << (WHEEL_BITS * (level + 1))){
+		level++;
+	}
+	if (delta >= 1ULL << (WHEEL_BITS * WHEEL_LEVELS)){
+		key = wheel->currentTick + (1ULL << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+	}
+	head = &wheel->slot[level][(key >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1)];
+
+	// Append to the slot's circular list
+	timer->next = head;
+	timer->prev = head->prev;
+	head->prev->next = timer;
+	head->prev = timer;
+}
+
+/*
+ * Function: armTimer
+ * ------------------
+ * Arms a timer to expire at deadline, O(1). A timer that is already armed is moved.
+ * Deadlines that already passed expire on the next tick.
+ *
+ * Parameters:
+ *      wheel    - wheel the timer belongs to
+ *      timer    - timer to arm
+ *      deadline - expiry time on the wheel's nanosecond clock
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void armTimer(struct timerWheel *wheel, struct wheelTimer *timer, unsigned long long deadline){
+	cancelTimer(wheel, timer);
+	// Round up, a timer never fires before its deadline
+	timer->expires = (deadline + WHEEL_TICK_NANOSECONDS - 1) / WHEEL_TICK_NANOSECONDS;
+	if (timer->expires <= wheel->currentTick){
+		timer->expires = wheel->currentTick + 1;
+	}
+	placeTimer(wheel, timer);
+	wheel->armedCount++;
+}
+
+/*
+ * Function: cancelTimer
+ * ---------------------
+ * Disarms a timer, O(1). Does nothing if the timer is not armed.
+ *
+ * Parameters:
+ *      wheel - wheel the timer belongs to
+ *      timer - timer to disarm
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void cancelTimer(struct timerWheel *wheel, struct wheelTimer *timer){
+	if (timer->next == NULL){
+		return;
+	}
+	timer->prev->next = timer->next;
+	timer->next->prev = timer->prev;
+	timer->next = NULL;
+	timer->prev = NULL;
+	wheel->armedCount--;
+}
+
+/*
+ * Function: cascadeSlot
+ * ---------------------
+ * Moves every timer of a higher level slot down to the level that now fits it.
+ *
+ * Parameters:
+ *      wheel - wheel being advanced
+ *      level - level of the slot (1 or higher)
+ *      index - slot within the level
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void cascadeSlot(struct timerWheel *wheel, int level, int index){
+	struct wheelTimer *head = &wheel->slot[level][index];
+	struct wheelTimer *timer = head->next;
+
+	// Detach the whole list first, placing may put timers back into this very slot
+	head->next = head;
+	head->prev = head;
+	while (timer != head){
+		struct wheelTimer *next = timer->next;
+		placeTimer(wheel, timer);
+		timer = next;
+	}
+}
+
+/*
+ * Function: expireTimers
+ * ----------------------
+ * Advances the wheel to now and hands every timer that came due to onExpire, as one
+ * batch. Each timer is disarmed before its callback runs, so the callback may arm it
+ * again. An empty wheel jumps straight to now.
+ *
+ * Parameters:
+ *      wheel    - wheel to advance
+ *      now      - current time on the wheel's nanosecond clock
+ *      onExpire - called once per expired timer
+ *      context  - passed through to onExpire
+ *
+ * Return:
+ *      int - Number of timers that expired.
+ */
+int expireTimers(struct timerWheel *wheel, unsigned long long now, void (*onExpire)(struct wheelTimer *timer, void *context), void *context){
+	unsigned long long target = now / WHEEL_TICK_NANOSECONDS;
+	int expired = 0;
+
+	while (wheel->currentTick < target){
+		struct wheelTimer due, *timer;
+		int index;
+
+		if (wheel->armedCount == 0){
+			wheel->currentTick = target;
+			break;
+		}
+		wheel->currentTick++;
+		// Every 64 ticks of a level, the next slot of the level above moves down
+		for (int level = 1; level < WHEEL_LEVELS; level++){
+			if ((wheel->currentTick & ((1ULL << (WHEEL_BITS * level)) - 1)) != 0){
+				break;
+			}
+			cascadeSlot(wheel, level, (wheel->currentTick >> (WHEEL_BITS * level)) & (WHEEL_SLOTS - 1));
+		}
+
+		// Take the due slot off the wheel, then fire its timers one by one
+		index = wheel->currentTick & (WHEEL_SLOTS - 1);
+		if (wheel->slot[0][index].next == &wheel->slot[0][index]){
+			continue;
+		}
+		due.next = wheel->slot[0][index].next;
+		due.prev = wheel->slot[0][index].prev;
+		due.next->prev = &due;
+		due.prev->next = &due;
+		wheel->slot[0][index].next = &wheel->slot[0][index];
+		wheel->slot[0][index].prev = &wheel->slot[0][index];
+		while ((timer = due.next) != &due){
+			due.next = timer->next;
+			timer->next->prev = &due;
+			timer->next = NULL;
+			timer->prev = NULL;
+			wheel->armedCount--;
+			onExpire(timer, context);
+			expired++;
+		}
+	}
+	return expired;
+}
@@ -0,0 +1,38 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Hierarchical timer wheel for connection deadlines. Four levels of 64 slots with a
+ *              10ms tick cover about 46 hours; arming and cancelling a timer are O(1) list
+ *              operations, expiring walks only the slots the clock passed (timers further out
+ *              cascade down a level every 64 ticks of the level below). Timers are intrusive: embed
+ *              a struct wheelTimer in the owning object. Not thread-safe, callers hold their own lock.
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+//Wheel geometry: WHEEL_LEVELS levels of 2^WHEEL_BITS slots, one tick is WHEEL_TICK_NANOSECONDS
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+#define WHEEL_TICK_NANOSECONDS 10000000ULL
+
+//Timer Structure, linked into one wheel slot while armed (next is NULL when it is not)
+struct wheelTimer{
+	struct wheelTimer *next;
+	struct wheelTimer *prev;
+	unsigned long long expires;
+};
+
+//Timer Wheel Structure, every slot is a circular list around its sentinel
+struct timerWheel{
+	struct wheelTimer slot[WHEEL_LEVELS][WHEEL_SLOTS];
+	unsigned long long currentTick;
+	int armedCount;
+};
+
+//function prototype
+void initTimerWheel(struct timerWheel *wheel, unsigned long long now);
+void armTimer(struct timerWheel *wheel, struct wheelTimer *timer, unsigned long long deadline);
+void cancelTimer(struct timerWheel *wheel, struct wheelTimer *timer);
+int expireTimers(struct timerWheel *wheel, unsigned long long now, void (*onExpire)(struct wheelTimer *timer, void *context), void *context);
+
+#endif
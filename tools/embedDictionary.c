@@ -0,0 +1,166 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Build step behind WWF_EMBED_DICTIONARY. Loads a word list with loadDictionary and
+ *              writes its tables out as C source (read-only arrays plus a struct dictionary named
+ *              embeddedTables), so the server starts without touching the file.
+ *              Usage: embedDictionary <wordList> <output.c>
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "dictionary.h"
+#include "puzzleIndex.h"
+#include "logger.h"
+
+//function prototype
+void writeWords(FILE *output, struct dictionary *dictionary);
+void writeHistograms(FILE *output, struct dictionary *dictionary);
+void writePuzzleIndex(FILE *output, struct dictionary *dictionary);
+
+//main
+int main(int argc, char **argv){
+	struct dictionary *dictionary;
+	FILE *output;
+
+	if (argc != 3){
+		fprintf(stderr, "Usage: %s <wordList> <output.c>\n", argv[0]);
+		return 1;
+	}
+	// No log writer runs here
+	logLevel = LOG_OFF;
+	dictionary = loadDictionary(argv[1]);
+	if (dictionary == NULL){
+		fprintf(stderr, "Could not load the dictionary %s\n", argv[1]);
+		return 1;
+	}
+	buildPuzzleIndex(dictionary);
+	output = fopen(argv[2], "w");
+	if (output == NULL){
+		fprintf(stderr, "Could not write %s\n", argv[2]);
+		return 1;
+	}
+
+	fprintf(output, "/* Generated by tools/embedDictionary.c from %s, do not edit. */\n", argv[1]);
+	fprintf(output, "#include \"dictionary.h\"\n#include \"puzzleIndex.h\"\n\n");
+	writeWords(output, dictionary);
+	writeHistograms(output, dictionary);
+	writePuzzleIndex(output, dictionary);
+
+	fprintf(output, "static const unsigned char embeddedLength[%d] = {", dictionary->wordCount);
+	for (int i = 0; i < dictionary->wordCount; i++){
+		fprintf(output, "%s%u", i == 0 ? "\n" : i % 32 ? "," : ",\n", dictionary->length[i]);
+	}
+	fprintf(output, "\n};\n\nstatic const unsigned int embeddedMask[%d] = {", dictionary->wordCount);
+	for (int i = 0; i < dictionary->wordCount; i++){
+		fprintf(output, "%s%u", i == 0 ? "\n" : i % 16 ? "," : ",\n", dictionary->mask[i]);
+	}
+	fprintf(output, "\n};\n\n");
+
+	fprintf(output, "struct dictionary embeddedTables = {\n\t.wordCount = %d,\n\t.bytes = embeddedBytes,\n"
+		"\t.offset = embeddedOffset,\n\t.length = embeddedLength,\n\t.histogram = embeddedHistogram,\n"
+		"\t.mask = embeddedMask,\n\t.master = embeddedMaster,\n\t.masterCount = %d,\n\t.isEmbedded = 1,\n"
+		"\t.refCount = 1\n};\n", dictionary->wordCount, dictionary->masterCount);
+
+	if (fclose(output) != 0){
+		fprintf(stderr, "Could not write %s\n", argv[2]);
+		return 1;
+	}
+	freeDictionary(dictionary);
+	return 0;
+}
+
+/*
+ * Function: writeWords
+ * --------------------
+ * Writes the word bytes (one string literal per word, each NUL-terminated) and their offsets.
+ *
+ * Parameters:
+ *      output     - generated source file
+ *      dictionary - loaded word list
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void writeWords(FILE *output, struct dictionary *dictionary){
+	unsigned int offset = 0;
+
+	fprintf(output, "static const char embeddedBytes[] =");
+	for (int i = 0; i < dictionary->wordCount; i++){
+		const char *word = dictionaryWord(dictionary, i);
+		fprintf(output, "\n\t\"");
+		for (int j = 0; j < dictionary->length[i]; j++){
+			if (word[j] == '"' || word[j] == '\\'){
+				fprintf(output, "\\%c", word[j]);
+			}
+			else if (word[j] < ' ' || word[j] > '~'){
+				fprintf(output, "\\%03o", (unsigned char)word[j]);
+			}
+			else{
+				fputc(word[j], output);
+			}
+		}
+		fprintf(output, "\\0\"");
+	}
+	fprintf(output, ";\n\nstatic const unsigned int embeddedOffset[%d] = {", dictionary->wordCount);
+	for (int i = 0; i < dictionary->wordCount; i++){
+		fprintf(output, "%s%u", i == 0 ? "\n" : i % 16 ? "," : ",\n", offset);
+		offset += dictionary->length[i] + 1;
+	}
+	fprintf(output, "\n};\n\n");
+}
+
+/*
+ * Function: writeHistograms
+ * -------------------------
+ * Writes the letter histogram rows as short string literals (every byte is an octal escape,
+ * the padding after 'z' is left to zero initialization).
+ *
+ * Parameters:
+ *      output     - generated source file
+ *      dictionary - loaded word list
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void writeHistograms(FILE *output, struct dictionary *dictionary){
+	fprintf(output, "static _Alignas(16) const unsigned char embeddedHistogram[%d][HISTOGRAM_WIDTH] = {",
+		dictionary->wordCount);
+	for (int i = 0; i < dictionary->wordCount; i++){
+		fprintf(output, "%s\n\t\"", i ? "," : "");
+		for (int j = 0; j < 26; j++){
+			fprintf(output, "\\%o", dictionary->histogram[i][j]);
+		}
+		fputc('"', output);
+	}
+	fprintf(output, "\n};\n\n");
+}
+
+/*
+ * Function: writePuzzleIndex
+ * --------------------------
+ * Writes the puzzle statistics of every indexed master word, in index order. Length
+ * counts stop at the last non-zero one.
+ *
+ * Parameters:
+ *      output     - generated source file
+ *      dictionary - loaded and indexed word list
+ *
+ * Return:
+ *      void - This function does not return a value.
+ */
+void writePuzzleIndex(FILE *output, struct dictionary *dictionary){
+	fprintf(output, "static const struct masterStats embeddedMaster[%d] = {", dictionary->masterCount + 1);
+	for (int i = 0; i < dictionary->masterCount; i++){
+		const struct masterStats *stats = &dictionary->master[i];
+		int last = MAX_WORD_LENGTH;
+		while (last > 0 && stats->lengthCount[last] == 0){
+			last--;
+		}
+		fprintf(output, "%s\n\t{%d,%d,%d,%d,{", i ? "," : "", stats->word, stats->solutionCount, stats->boardBytes,
+			stats->longestWord);
+		for (int length = 0; length <= last; length++){
+			fprintf(output, "%s%u", length ? "," : "", stats->lengthCount[length]);
+		}
+		fprintf(output, "}}");
+	}
+	fprintf(output, "\n};\n\n");
+}
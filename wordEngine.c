@@ -0,0 +1,967 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Word engine of the game, see wordEngine.h.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include <limits.h>
+#include "wordEngine.h"
+#include "dictionary.h"
+#include "puzzleIndex.h"
+#include "logger.h"
+#include "metrics.h"
+
+//Global variable 
+int BUFFER_SIZE = 1024;
+const char *dictionaryPath = NULL;
+void (*wordsFoundHook)(struct puzzle *puzzle, struct gameListNode **words, int count, int isGuessed) = NULL;
+//Id handed to the next puzzle built
+unsigned long puzzleCounter = 0;
+//State of the master word picker, see seedRandomWord
+unsigned int randomWordSeed = 1;
+//Board size range of new puzzles (words on the board, master word included)
+int puzzleMinSolutions = 1;
+int puzzleMaxSolutions = INT_MAX;
+
+/*
+ * buildPuzzle - Picks a random master word and builds a fresh puzzle around it.
+ *               Only called from main at startup and from the puzzle builder thread.
+ *               The puzzle keeps a reference on the dictionary it was built from.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  struct puzzle* - The new puzzle holding one reference for its owner, or NULL on failure.
+ */
+struct puzzle *buildPuzzle(){
+	struct puzzle *puzzle = (struct puzzle *)malloc(sizeof(struct puzzle));
+	if (puzzle == NULL){
+		return NULL;
+	}
+	// a reload may swap the dictionary at any time, stick to the current one
+	puzzle->dictionary = acquireDictionary();
+	if (puzzle->dictionary == NULL){
+		free(puzzle);
+		return NULL;
+	}
+	// get the master word from dictionary randomly
+	unsigned long long stageStart = nowNanoseconds();
+	const char *masterWord = getRandomWord(puzzle->dictionary);
+	if (masterWord == NULL){
+		releaseDictionary(puzzle->dictionary);
+		free(puzzle);
+		return NULL;
+	}
+	strcpy(puzzle->masterWord, masterWord);
+	observeLatency(&stageHistogram[STAGE_RANDOM_WORD], stageStart);
+	// find all possible word that can formed by uses the letters of master word
+	stageStart = nowNanoseconds();
+	puzzle->gameRoot = findWords(puzzle->dictionary, puzzle->masterWord);
+	observeLatency(&stageHistogram[STAGE_FIND_WORDS], stageStart);
+	// capitalize once here so request threads only ever read the list
+	capitalizedWordInGameList(puzzle->gameRoot);
+	setAllWordsToNotFound(puzzle->gameRoot);
+
+	puzzle->id = ++puzzleCounter;
+	puzzle->wordCount = 0;
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		puzzle->wordCount++;
+	}
+	buildHintIndex(puzzle);
+	puzzle->startedAt = 0;
+	atomic_init(&puzzle->foundCount, 0);
+	atomic_init(&puzzle->refCount, 1);
+	atomic_init(&puzzle->isCompleted, 0);
+	return puzzle;
+}
+/*
+ * assemblePuzzle - Builds a puzzle around a board that is already known (restored from a
+ *                  snapshot, or dealt by another process through shared memory) on the
+ *                  current dictionary, without picking a master word or looking words up.
+ *
+ * Parameters:
+ *  unsigned long id - The puzzle id.
+ *  const char *masterWord - The master word.
+ *  const char *words - Capitalized board words in board order, one every stride bytes.
+ *  size_t stride - Bytes from one word to the next, words are cut to fit a game list node.
+ *  int wordCount - Number of words.
+ *  const uint64_t *found - Found bitset in board order, NULL if no word is found yet.
+ *
+ * Return:
+ *  struct puzzle* - The puzzle holding one reference for its owner, or NULL on failure.
+ */
+struct puzzle *assemblePuzzle(unsigned long id, const char *masterWord, const char *words, size_t stride, int wordCount, const uint64_t *found){
+	struct puzzle *puzzle = (struct puzzle *)calloc(1, sizeof(struct puzzle));
+	struct gameListNode *tail = NULL, *node;
+	char text[sizeof(((struct gameListNode *)0)->str)];
+	int foundCount = 0, isFound;
+
+	if (puzzle == NULL){
+		return NULL;
+	}
+	puzzle->dictionary = acquireDictionary();
+	if (puzzle->dictionary == NULL){
+		free(puzzle);
+		return NULL;
+	}
+	atomic_init(&puzzle->refCount, 1);
+	puzzle->id = id;
+	snprintf(puzzle->masterWord, sizeof(puzzle->masterWord), "%s", masterWord);
+	for (int i = 0; i < wordCount; i++){
+		memcpy(text, words + (size_t)i * stride, stride < sizeof(text) ? stride : sizeof(text));
+		text[sizeof(text) - 1] = '\0';
+		node = createGameList(text);
+		isFound = found != NULL ? (found[i / 64] >> (i % 64)) & 1 : 0;
+		atomic_init(&node->isFound, isFound);
+		foundCount += isFound;
+		if (tail == NULL){
+			puzzle->gameRoot = node;
+		}
+		else{
+			tail->next = node;
+		}
+		tail = node;
+		puzzle->wordCount++;
+	}
+	atomic_init(&puzzle->foundCount, foundCount);
+	buildHintIndex(puzzle);
+	return puzzle;
+}
+/*
+ * releasePuzzle - Drops a reference on a puzzle and frees it after the last one.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle to release.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void releasePuzzle(struct puzzle *puzzle){
+	if (atomic_fetch_sub(&puzzle->refCount, 1) == 1){
+		cleanupGameListNode(puzzle->gameRoot);
+		releaseDictionary(puzzle->dictionary);
+		free(puzzle->hintOrder);
+		free(puzzle);
+	}
+}
+/*
+ * initialization - Sets up the dictionary the puzzles are built from: the tables compiled into
+ *                  the binary when there are any and no other list was asked for, otherwise the
+ *                  word list file at dictionaryPath ("2of12.txt" by default).
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  int - The total number of words in the dictionary (word count), 0 on failure.
+ */
+int initialization(){	
+	// Generate a random seed based on the current time (seedRandomWord overrides it)
+	seedRandomWord(time(NULL));
+
+	// Built-in tables: no file I/O, no parsing
+	if (dictionaryPath == NULL){
+		wordDictionary = embeddedDictionary();
+	}
+	// Runtime loading, for custom word lists and builds without the tables
+	if (wordDictionary == NULL){
+		wordDictionary = loadDictionary(dictionaryPath != NULL ? dictionaryPath : "2of12.txt");
+		if (wordDictionary == NULL){
+			return 0;
+		}
+		// The built-in tables come with their puzzle index, a loaded list is indexed here
+		if (buildPuzzleIndex(wordDictionary) == 0){
+			LOG(LOG_ERROR, "event=dictionary_rejected words=%d reason=no_master_word", wordDictionary->wordCount);
+			cleanupDictionary();
+			return 0;
+		}
+	}
+	LOG(LOG_INFO, "event=dictionary_ready words=%d master_words=%d source=%s", wordDictionary->wordCount,
+		wordDictionary->masterCount, wordDictionary->isEmbedded ? "embedded" : (dictionaryPath != NULL ? dictionaryPath : "2of12.txt"));
+
+	// Return the total number of words in the dictionary
+	return wordDictionary->wordCount;
+}
+/*
+ * reloadDictionary - Loads and indexes the word list at dictionaryPath again ("2of12.txt" in the
+ *                    working directory when running on the built-in tables), builds its puzzle
+ *                    index and swaps it in.
+ *                    Puzzles already built keep the old one until they are released. On
+ *                    failure the current dictionary stays in place.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  int - The word count of the new dictionary, or 0 if it was not swapped in.
+ */
+int reloadDictionary(){
+	const char *path = dictionaryPath != NULL ? dictionaryPath : "2of12.txt";
+	unsigned long long start = nowNanoseconds();
+	struct dictionary *dictionary = loadDictionary(path);
+
+	if (dictionary == NULL){
+		return 0;
+	}
+	// getRandomWord needs at least one master word that fits the board
+	if (buildPuzzleIndex(dictionary) == 0){
+		LOG(LOG_ERROR, "event=dictionary_reload_rejected path=%s words=%d reason=no_master_word", path, dictionary->wordCount);
+		releaseDictionary(dictionary);
+		return 0;
+	}
+	swapDictionary(dictionary);
+	LOG(LOG_INFO, "event=dictionary_reloaded path=%s words=%d master_words=%d duration_ms=%.1f", path,
+		dictionary->wordCount, dictionary->masterCount, (nowNanoseconds() - start) / 1e6);
+	return dictionary->wordCount;
+}
+/*
+ * seedRandomWord - Seeds the master word picker. initialization seeds it from the
+ *                  clock; benchmarks and load tests pass a fixed seed to get the
+ *                  same sequence of puzzles on every run.
+ *
+ * Parameters:
+ *  unsigned int seed - The seed.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void seedRandomWord(unsigned int seed){
+	randomWordSeed = seed;
+}
+/*
+ * Function: acceptInput
+ * ----------------------
+ * Processes user input, converts to uppercase, and checks for matches in the game list.
+ *
+ * Parameters:
+ *      puzzle - Puzzle the guess is played against.
+ *      input - User input string.
+ *
+ * Return:
+ *      char* - Processed user input.
+ */
+char *acceptInput(struct puzzle *puzzle, char *input){
+	// Temporary pointer to traverse the game list
+	struct gameListNode *temp = puzzle->gameRoot;
+	// Outcome of the guess, for the log
+	const char *result = "wrong";
+	// Allocate memory for the user's input (maximum of 100 characters)
+	//char *input = (char *)malloc(sizeof(char) * 100);
+	// Read user input from stdin (up to 100 characters)
+	//fgets(input, 100, stdin);			
+	// Remove newline characters from the input string		
+	input[strcspn(input, "\r\n")] = '\0';		
+	// Convert all characters in the input to uppercase		
+	for (int i = 0; i < strlen(input); i++){			
+		input[i] = toupper(input[i]);				
+	}
+	// Check if the input is the cheat code ("110")
+	if (strcmp(input, "110") == 0){
+		cheat(puzzle);
+		result = "cheat";
+	}
+	// Traverse the game list and mark words as found if the user's input matches any word
+	while(temp){
+		if (strcmp(input, temp->str) == 0){
+			result = "already";
+			// Only the guess that flips the word to found counts it and reports it
+			if (atomic_exchange(&temp->isFound, 1) == 0){
+				result = "found";
+				atomic_fetch_add(&puzzle->foundCount, 1);
+				if (wordsFoundHook != NULL){
+					wordsFoundHook(puzzle, &temp, 1, 1);
+				}
+			}
+		}
+		temp = temp->next;
+	}
+	// Log the processed user input and what it did
+	LOG(LOG_INFO, "event=guess puzzle=%lu guess=%s result=%s", puzzle->id, input, result);
+	// Return the processed input
+	return input;
+}
+/*
+ * Function: compareGuess
+ * ----------------------
+ * qsort/bsearch comparator ordering guesses alphabetically, then by their position in the batch.
+ */
+int compareGuess(const void *a, const void *b){
+	const struct guessRef *left = (const struct guessRef *)a, *right = (const struct guessRef *)b;
+	int order = strcmp(left->word, right->word);
+	if (order != 0 || left->index < 0 || right->index < 0){
+		return order;
+	}
+	return left->index - right->index;
+}
+/*
+ * Function: acceptGuesses
+ * -----------------------
+ * Applies a batch of guesses in a single pass over the game list. The guesses are
+ * uppercased and sorted, then every game word is looked up among them with a
+ * binary search. Newly found words are reported to wordsFoundHook in one call.
+ *
+ * Parameters:
+ *      puzzle     - puzzle the guesses are played against
+ *      guesses    - array of guesses, uppercased in place
+ *      guessCount - number of guesses
+ *      results    - receives GUESS_WRONG, GUESS_FOUND or GUESS_ALREADY_FOUND per guess
+ *
+ * Return:
+ *      int - The number of words this batch newly found.
+ */
+int acceptGuesses(struct puzzle *puzzle, char **guesses, int guessCount, int *results){
+	struct gameListNode *temp = puzzle->gameRoot;
+	struct guessRef *sorted, key, *match;
+	struct gameListNode **newlyFound;
+	int newlyFoundCount = 0;
+
+	if (guessCount == 0){
+		return 0;
+	}
+	sorted = (struct guessRef *)malloc(sizeof(struct guessRef) * guessCount);
+	newlyFound = (struct gameListNode **)malloc(sizeof(struct gameListNode *) * guessCount);
+	if (sorted == NULL || newlyFound == NULL){
+		free(sorted);
+		free(newlyFound);
+		return 0;
+	}
+
+	// Normalize the guesses the same way acceptInput does, then sort them for lookup
+	for (int i = 0; i < guessCount; i++){
+		for (char *letter = guesses[i]; *letter; letter++){
+			*letter = toupper(*letter);
+		}
+		results[i] = GUESS_WRONG;
+		sorted[i].word = guesses[i];
+		sorted[i].index = i;
+	}
+	qsort(sorted, guessCount, sizeof(struct guessRef), compareGuess);
+
+	// One walk over the game list resolves every guess
+	key.index = -1;
+	while (temp){
+		key.word = temp->str;
+		match = (struct guessRef *)bsearch(&key, sorted, guessCount, sizeof(struct guessRef), compareGuess);
+		if (match != NULL){
+			// Rewind to the earliest duplicate of this guess
+			while (match > sorted && strcmp((match - 1)->word, temp->str) == 0){
+				match--;
+			}
+			// The first guess of a newly found word gets the credit, repeats are already found
+			results[match->index] = atomic_exchange(&temp->isFound, 1) == 0 ? GUESS_FOUND : GUESS_ALREADY_FOUND;
+			if (results[match->index] == GUESS_FOUND){
+				newlyFound[newlyFoundCount++] = temp;
+			}
+			for (match++; match < sorted + guessCount && strcmp(match->word, temp->str) == 0; match++){
+				results[match->index] = GUESS_ALREADY_FOUND;
+			}
+		}
+		temp = temp->next;
+	}
+
+	// Count the whole batch, then report it once (a single state version bump)
+	if (newlyFoundCount > 0){
+		atomic_fetch_add(&puzzle->foundCount, newlyFoundCount);
+		if (wordsFoundHook != NULL){
+			wordsFoundHook(puzzle, newlyFound, newlyFoundCount, 1);
+		}
+	}
+
+	LOG(LOG_INFO, "event=batch puzzle=%lu guesses=%d found=%d", puzzle->id, guessCount, newlyFoundCount);
+	free(sorted);
+	free(newlyFound);
+	return newlyFoundCount;
+}
+/*
+ * buildHintIndex - Sorts the words of a finished board for hint queries: counted out by
+ *                  length, then alphabetically within each length, so every length and
+ *                  every prefix within a length is one contiguous range of hintOrder.
+ *                  Words must already be capitalized.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle, wordCount set.
+ *
+ * Return:
+ *  int - 0 on success, -1 if the index could not be allocated (hints then find nothing).
+ */
+int buildHintIndex(struct puzzle *puzzle){
+	int next[MAX_WORD_LENGTH + 2];
+	int length;
+
+	memset(puzzle->lengthStart, 0, sizeof(puzzle->lengthStart));
+	puzzle->hintOrder = (struct gameListNode **)malloc(sizeof(struct gameListNode *) * (puzzle->wordCount + 1));
+	if (puzzle->hintOrder == NULL){
+		return -1;
+	}
+	// Counting sort on length: count, turn counts into starts, then place
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		length = strlen(temp->str);
+		puzzle->lengthStart[(length > MAX_WORD_LENGTH ? MAX_WORD_LENGTH : length) + 1]++;
+	}
+	for (int i = 1; i <= MAX_WORD_LENGTH + 1; i++){
+		puzzle->lengthStart[i] += puzzle->lengthStart[i - 1];
+	}
+	memcpy(next, puzzle->lengthStart, sizeof(next));
+	for (struct gameListNode *temp = puzzle->gameRoot; temp; temp = temp->next){
+		length = strlen(temp->str);
+		puzzle->hintOrder[next[length > MAX_WORD_LENGTH ? MAX_WORD_LENGTH : length]++] = temp;
+	}
+	for (int i = 1; i <= MAX_WORD_LENGTH; i++){
+		qsort(puzzle->hintOrder + puzzle->lengthStart[i], puzzle->lengthStart[i + 1] - puzzle->lengthStart[i],
+			sizeof(struct gameListNode *), compareHintWord);
+	}
+	return 0;
+}
+/*
+ * compareHintWord - qsort comparator ordering game list nodes alphabetically.
+ */
+int compareHintWord(const void *a, const void *b){
+	return strcmp((*(struct gameListNode *const *)a)->str, (*(struct gameListNode *const *)b)->str);
+}
+/*
+ * hintRange - Finds the words of one length that start with prefix, with two binary
+ *             searches over that length's part of the hint index.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle.
+ *  int length - Word length, 1 to MAX_WORD_LENGTH.
+ *  const char *prefix - Capitalized prefix, "" for every word of the length.
+ *  int *first - Receives the position of the first match in hintOrder.
+ *
+ * Return:
+ *  int - The number of matches, hintOrder[*first] onwards.
+ */
+int hintRange(struct puzzle *puzzle, int length, const char *prefix, int *first){
+	int prefixLength = strlen(prefix), low, high, middle, end;
+
+	*first = 0;
+	if (puzzle->hintOrder == NULL || length < 1 || length > MAX_WORD_LENGTH || prefixLength > length){
+		return 0;
+	}
+	// Lower bound: first word not ordered before the prefix
+	low = puzzle->lengthStart[length];
+	high = puzzle->lengthStart[length + 1];
+	while (low < high){
+		middle = low + (high - low) / 2;
+		if (strncmp(puzzle->hintOrder[middle]->str, prefix, prefixLength) < 0){
+			low = middle + 1;
+		}
+		else{
+			high = middle;
+		}
+	}
+	*first = low;
+	// Upper bound: first word ordered after every word with the prefix
+	high = puzzle->lengthStart[length + 1];
+	while (low < high){
+		middle = low + (high - low) / 2;
+		if (strncmp(puzzle->hintOrder[middle]->str, prefix, prefixLength) <= 0){
+			low = middle + 1;
+		}
+		else{
+			high = middle;
+		}
+	}
+	end = low;
+	return end - *first;
+}
+/*
+ * countHints - Counts the words of a length (0 for any) that start with prefix.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle.
+ *  int length - Word length, or 0 for every length.
+ *  const char *prefix - Capitalized prefix, "" for none.
+ *  int *hidden - Receives how many of them are not found yet.
+ *
+ * Return:
+ *  int - The number of matching words.
+ */
+int countHints(struct puzzle *puzzle, int length, const char *prefix, int *hidden){
+	int first, count, total = 0;
+
+	*hidden = 0;
+	for (int i = length == 0 ? 1 : length; i <= (length == 0 ? MAX_WORD_LENGTH : length); i++){
+		count = hintRange(puzzle, i, prefix, &first);
+		for (int j = first; j < first + count; j++){
+			if (atomic_load(&puzzle->hintOrder[j]->isFound) == 0){
+				(*hidden)++;
+			}
+		}
+		total += count;
+	}
+	return total;
+}
+/*
+ * revealHint - Reveals the first hidden word (shortest, then alphabetically) of a length
+ *              (0 for any) that starts with prefix. The word is flipped to found with an
+ *              atomic exchange, so a guess or another hint racing for it counts it once.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle.
+ *  int length - Word length, or 0 for every length.
+ *  const char *prefix - Capitalized prefix, "" for none.
+ *
+ * Return:
+ *  struct gameListNode* - The revealed word, or NULL if every matching word is found.
+ */
+struct gameListNode *revealHint(struct puzzle *puzzle, int length, const char *prefix){
+	struct gameListNode *word;
+	int first, count;
+
+	for (int i = length == 0 ? 1 : length; i <= (length == 0 ? MAX_WORD_LENGTH : length); i++){
+		count = hintRange(puzzle, i, prefix, &first);
+		for (int j = first; j < first + count; j++){
+			word = puzzle->hintOrder[j];
+			if (atomic_exchange(&word->isFound, 1) == 0){
+				atomic_fetch_add(&puzzle->foundCount, 1);
+				LOG(LOG_INFO, "event=hint_reveal puzzle=%lu word=%s", puzzle->id, word->str);
+				if (wordsFoundHook != NULL){
+					wordsFoundHook(puzzle, &word, 1, 0);
+				}
+				return word;
+			}
+		}
+	}
+	return NULL;
+}
+/*
+ * displayWord - Displays the letters of the master word in uppercase and sorted order.
+ *
+ * Parameters:
+ *  char *masterWordStr - The string representing the master word.
+ *
+ * Return:
+ *  *char - formated master word string
+ */
+char *displayWord(char *masterWordStr){
+	// Get the length of the master word string
+    	int length = strlen(masterWordStr);
+    
+    	// Create a char array to store the letters of the word
+    	char *word = (char *)malloc(sizeof(char) * (length + 1));
+	memset(word, 0, sizeof(char) * (length + 1));
+	char letter;
+
+	// Loop through each character of the word and process it
+	for (int i = 0; i < length; i++){
+		// Store the current character in the letter variable
+		letter = masterWordStr[i];
+
+		// Only process alphabetic characters
+		if (isalpha(letter)){ 		
+			// Convert the letter to uppercase and store it in the word array
+			word[i] = toupper(letter);	
+		}
+	}
+
+	// Sort the array of letters
+	/*
+	 * Compare each letter to every letter with a greater index.
+	 * If the current letter is smaller, swap their positions.
+	 */
+	for (int i = 0; i < length; i++){
+		for (int j = 1; i + j < length; j++){
+			if (word[i] <= word[i + j]){
+				// Swap the letters
+				letter = word[i];
+				word[i] = word[i + j];
+				word[i + j] = letter;
+			}
+		}
+	}
+
+	// Log the sorted list of letters
+	LOG(LOG_DEBUG, "event=rack letters=%s", word);
+	return word;
+}
+/*
+ * isDone - Checks if all the words in the game list have been found.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle to check.
+ *
+ * Return:
+ *  int - Returns 1 if all words have been found, otherwise returns 0 to continue the game.
+ */
+int isDone(struct puzzle *puzzle){	
+	// Every newly found word is counted, so there is no need to walk the list
+	if (atomic_load(&puzzle->foundCount) >= puzzle->wordCount){
+		return 1;
+	}
+	return 0;
+}
+/*
+ * getLetterDistribution - Calculates the frequency of each letter in the input string.
+ *
+ * Parameters:
+ *  char *strInput - The input string for which to count letter occurrences.
+ *
+ * Return:
+ *  int* - An array of 26 integers representing the count of each letter (A-Z) in the input string.
+ */
+int *getLetterDistribution(char *strInput){
+	// Allocate memory for an array of 26 integers (one for each letter of the alphabet)
+	int *letterCounter = (int *)malloc(sizeof(int) * 26);
+
+	//init the array to 0
+	memset(letterCounter, 0, sizeof(int) * 26);
+
+	// Loop over the input string to count the occurrences of each letter
+	for (int i = 0; i < strlen(strInput); i++){				
+		// If the character is a lowercase letter (a-z)
+		if (strInput[i] >= 'a' && strInput[i] <= 'z'){		
+			// Increment the corresponding array index for this letter
+			letterCounter[(int)strInput[i] - 97] += 1;		
+		}
+		// If the character is an uppercase letter (A-Z)
+		else if (strInput[i] >= 'A' && strInput[i] <= 'Z'){	
+			// Increment the corresponding array index for this letter
+			letterCounter[(int)strInput[i] - 65] += 1;		
+		}
+	}
+
+	// Return the array containing letter counts
+	return letterCounter;
+}
+/**
+ * compareCounts - Compares the letter counts of the master word and the words in the dictionary.
+ *
+ * Parameters:
+ *  int *choiceCount - Array representing the letter counts of the master word.
+ *  int *userInputCount - Array representing the letter counts of the dictionary word.
+ *
+ * Return:
+ *  int - Returns 1 (true) if the word in the dictionary can be formed from the master word letters, otherwise returns 0 (false).
+ */
+int compareCounts(int *choiceCount, int *userInputCount){
+	// Loop through the letter counts (for each letter A-Z)
+	for (int i = 0; i < 26; i++){
+		// If the master word has fewer occurrences of a letter than the user's input
+		if (choiceCount[i] < userInputCount[i]){			
+			// Return 0 (false) as the input cannot be made from the master word
+			return 0;						
+		}
+	}
+	// If all conditions are met, return 1 (true)
+	return 1;
+}
+/**
+ * getRandomWord - Selects a random master word (longer than 6 letters) from the dictionary's
+ *                 puzzle index, within puzzleMinSolutions..puzzleMaxSolutions words on the
+ *                 board when any master word qualifies.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - The dictionary to pick from.
+ *
+ * Return:
+ *  const char* - Returns the randomly selected word (valid until the next call on this thread),
+ *                or NULL if the dictionary has no master word.
+ */
+const char *getRandomWord(struct dictionary *dictionary){
+	static _Thread_local char word[MAX_WORD_LENGTH + 1];
+
+	// Two binary searches over the index (see seedRandomWord for the random state)
+	int index = pickMasterWord(dictionary, puzzleMinSolutions, puzzleMaxSolutions, &randomWordSeed);
+
+	// Nothing matches the constraints, any master word will do
+	if (index == -1){
+		LOG(LOG_WARN, "event=no_master_word_in_range min=%d max=%d", puzzleMinSolutions, puzzleMaxSolutions);
+		index = pickMasterWord(dictionary, 1, INT_MAX, &randomWordSeed);
+	}
+	if (index == -1){
+		LOG(LOG_ERROR, "event=no_master_word words=%d", dictionary->wordCount);
+		return NULL;
+	}
+
+	// Dictionary words are not terminated, hand out a copy
+	memcpy(word, dictionaryWord(dictionary, index), dictionary->length[index]);
+	word[dictionary->length[index]] = '\0';
+	return word;
+}
+/**
+ * createGameList - Creates a root node for the game list.
+ *
+ * Parameters:
+ *  char *word - The word to store in the game list root node.
+ *
+ * Return:
+ *  struct gameListNode* - Returns a pointer to the newly created game list root node, or NULL if it cannot be allocated.
+ */
+struct gameListNode *createGameList(char *word){			
+	// Remove the newline character from the word
+	word[strcspn(word, "\n")] = '\0';
+
+	// Dynamically allocate memory for the new game list node
+	struct gameListNode *root = (struct gameListNode*)malloc(sizeof(struct gameListNode));
+	if (root == NULL){
+		return NULL;
+	}
+
+	// Copy the word into the node's string field
+	strcpy(root->str, word);
+
+	// Set the next pointer to NULL since it's the root node
+	root->next = NULL;
+
+	// Return the newly created root node
+	return root;
+}
+/**
+ * addGameListNode - Adds a new node to the game list after the last node.
+ *
+ * Parameters:
+ *  char *word - The word to store in the new game list node.
+ *  struct gameListNode *root - The root node of the game list.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void addGameListNode(char *word, struct gameListNode *root){
+	// Remove the newline character from the word
+	word[strcspn(word, "\n")] = '\0';
+
+	// Check if the root node exists
+	if (root == NULL){
+		LOG(LOG_ERROR, "event=game_list_error reason=no_root word=%s", word);
+		return;
+	}
+
+	// Create a new game list node to add to the list
+	struct gameListNode *newNode = createGameList(word);
+
+	// Check if the new node was successfully created
+	if (newNode == NULL){
+		LOG(LOG_ERROR, "event=game_list_error reason=alloc word=%s", word);
+		return;
+	}
+
+	// Traverse the list to find the last node
+	while (root->next != NULL){
+		root = root->next;
+	}
+
+	// Attach the new node to the end of the list
+	root->next = newNode;
+}
+/**
+ * findWords - Finds and creates a game list of words from the dictionary that can be formed using the letters of the master word.
+ *
+ * Parameters:
+ *  struct dictionary *dictionary - The dictionary to search.
+ *  char *masterWord - The master word whose letters are used to form other words from the dictionary.
+ *
+ * Return:
+ *  struct gameListNode* - Returns the root of the game list, which contains words formed from the master word.
+ */
+struct gameListNode *findWords(struct dictionary *dictionary, char *masterWord){
+	// Root and last node of the game list being built
+	struct gameListNode *gameRoot = NULL, *tail = NULL, *newNode;
+	// Copy of the current match, dictionary words are not terminated
+	char word[MAX_WORD_LENGTH + 1];
+
+	// Check if the dictionary exists
+	if (dictionary == NULL){
+		LOG(LOG_ERROR, "event=find_words_error reason=no_dictionary master=%s", masterWord);
+		return NULL;
+	}
+
+	// Indexes of every dictionary word that can be formed using the letters of the master word
+	int *matches = (int *)malloc(sizeof(int) * (dictionary->wordCount + 1));
+	int matchCount = findFormableWords(dictionary, masterWord, matches);
+
+	// Append the matches to the game list, in dictionary order
+	for (int i = 0; i < matchCount; i++){
+		memcpy(word, dictionaryWord(dictionary, matches[i]), dictionary->length[matches[i]]);
+		word[dictionary->length[matches[i]]] = '\0';
+		newNode = createGameList(word);
+		if (newNode == NULL){
+			LOG(LOG_ERROR, "event=game_list_error reason=alloc word=%s", word);
+			break;
+		}
+		if (gameRoot == NULL){
+			gameRoot = newNode;
+		}
+		else{
+			tail->next = newNode;
+		}
+		tail = newNode;
+	}
+
+	// Free the match indexes
+	free(matches);
+
+	// Return the root of the game list containing words formed from the master word
+	return gameRoot;
+}
+/*
+ * Function: displayGameList
+ * --------------------------
+ * Displays words in the game list, showing dashes for unfound words and printing found words.
+ *
+ * Parameters:
+ *      root - Root node of the game list.
+ *
+ * Return:
+ *      char* - HTML representation of the game list.
+ */
+char *displayGameList(struct gameListNode *root){
+	// the puzzle index never picks a master word whose board would not fit
+	char gameContent[BOARD_BUFFER_SIZE];
+	memset(gameContent, 0, sizeof(gameContent));
+
+	// Variable to hold the length of each word
+	int wordLength;
+
+	// Check if the root of the game list exists
+	if (root == NULL){
+		LOG(LOG_WARN, "event=empty_game_list");
+	}
+
+	// Temporary pointer to traverse the game list
+	struct gameListNode *temp = root;
+
+	strcat(gameContent, "<div class=\"container\">");
+	// Traverse the game list and display each word
+	while (temp){
+		// If the word has not been found, print dashes in place of the letters
+		if (temp->isFound == 0){
+			strcat(gameContent, "<p>");
+			wordLength = strlen(temp->str);		
+			for (int i = 0; i < wordLength; i++){
+				strcat(gameContent, "_ ");	
+			}
+			strcat(gameContent, "</p>\n");
+			temp = temp->next;
+		}
+		// If the word has been found, print the word (html_ized game content)
+		else{
+			strcat(gameContent, "<p>");
+			strcat(gameContent, "Found:");
+			strcat(gameContent, temp->str);
+			strcat(gameContent, "</p>\n");
+			temp = temp->next;
+		}
+	}
+	strcat(gameContent, "</div>");
+
+	char *buffer = (char *)malloc(sizeof(char) * (strlen(gameContent) + 1));
+	memset(buffer, 0, sizeof(char) * (strlen(gameContent) + 1));
+	strcpy(buffer, gameContent);
+	return buffer;
+}
+/*
+ * capitalizedWordInGameList - Converts all words in the game list to uppercase.
+ *
+ * Parameters:
+ *  struct gameListNode *root - The root node of the game list.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void capitalizedWordInGameList(struct gameListNode *root){
+	// Traverse each node in the game list
+	while (root){
+		// Convert each character of the word to uppercase
+		for (int i = 0; i < strlen(root->str); i++){
+			(root->str)[i] = toupper((root->str)[i]);
+
+			// Strip off carriage returns and line feeds from the word
+			root->str[strcspn(root->str, "\r\n")] = '\0';				
+		}
+
+		// Move to the next node in the list
+		root = root->next;
+	}
+}
+/*
+ * cheat - Marks all words in the game list as found.
+ *
+ * Parameters:
+ *  struct puzzle *puzzle - The puzzle to reveal.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void cheat(struct puzzle *puzzle){
+	// Temporary pointer to traverse the game list
+	struct gameListNode *temp = puzzle->gameRoot;
+	// Words revealed by this call, reported together
+	struct gameListNode **newlyFound = (struct gameListNode **)malloc(sizeof(struct gameListNode *) * puzzle->wordCount);
+	int newlyFoundCount = 0;
+
+	if (newlyFound == NULL){
+		return;
+	}
+	// Mark all words as found, remembering the ones that were still hidden
+	while (temp){
+		if (atomic_exchange(&temp->isFound, 1) == 0){
+			newlyFound[newlyFoundCount++] = temp;
+		}
+		temp = temp->next;
+	}
+	if (newlyFoundCount > 0){
+		atomic_fetch_add(&puzzle->foundCount, newlyFoundCount);
+		if (wordsFoundHook != NULL){
+			wordsFoundHook(puzzle, newlyFound, newlyFoundCount, 0);
+		}
+	}
+	free(newlyFound);
+}
+/**
+ * setAllWordsToNotFound - Marks all words in the game list as not found.
+ *
+ * Parameters:
+ *  struct gameListNode *root - The root node of the game list.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void setAllWordsToNotFound(struct gameListNode *root){
+	// Temporary pointer to traverse the game list
+	struct gameListNode *temp = root;
+
+	// Mark all words as not found
+	while (temp){
+		temp->isFound = 0;
+		temp = temp->next;
+	}
+}
+/*
+ * cleanupGameListNode - Frees all nodes in the game list, releasing memory.
+ *
+ * Parameters:
+ *  struct gameListNode *root - The root node of the game list.
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void cleanupGameListNode(struct gameListNode *root){
+	// Temporary pointer to free each node in the game list
+	struct gameListNode *temp = NULL;
+
+	// Loop through and free each node
+	while (root){
+		temp = root;
+		root = root->next;
+		free(temp);
+	}
+}
+/*
+ * cleanupDictionary - Drops the current dictionary (freed once no puzzle uses it anymore).
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  void - This function does not return a value.
+ */
+void cleanupDictionary(){
+	releaseDictionary(wordDictionary);
+	wordDictionary = NULL;
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Project Name: FinalAssignment - web_ized word without friends
+ * Description: Word engine of the game: sets up the dictionary, picks master words, finds every word
+ *              that can be formed from a master word, applies guesses and renders the board.
+ *              Shared by the web server and the benchmarks.
+ */
+#ifndef WORD_ENGINE_H
+#define WORD_ENGINE_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include "dictionary.h"
+
+//game List Node Structure
+struct gameListNode{
+	char str[30];
+	atomic_int isFound;
+	struct gameListNode *next;
+};
+//Puzzle Structure, one board and its progress. Swapped in whole on rollover and
+//freed once the last request holding a reference releases it. Holds a reference
+//on the dictionary it was built from.
+struct puzzle{
+	unsigned long id;
+	struct dictionary *dictionary;
+	char masterWord[30];
+	struct gameListNode *gameRoot;
+	int wordCount;
+	atomic_int foundCount;
+	atomic_int refCount;
+	//Hint index built with the puzzle: the words sorted by length, then alphabetically.
+	//Words of length n are hintOrder[lengthStart[n]] up to hintOrder[lengthStart[n + 1]]
+	struct gameListNode **hintOrder;
+	int lengthStart[MAX_WORD_LENGTH + 2];
+	//When the puzzle went up for play (nowNanoseconds, set by the server), and whether its completion was scored
+	unsigned long long startedAt;
+	atomic_int isCompleted;
+};
+//Batched guess reference, sorted so game words can be looked up with bsearch
+struct guessRef{
+	char *word;
+	int index;
+};
+
+//Per-guess results reported by acceptGuesses
+#define GUESS_WRONG 0
+#define GUESS_FOUND 1
+#define GUESS_ALREADY_FOUND 2
+
+//function prototype 
+int initialization();
+int reloadDictionary();
+int compareCounts(int *choiceCount, int *userInputCount);
+int *getLetterDistribution(char *strInput);
+int isDone(struct puzzle *puzzle);
+char *displayGameList(struct gameListNode *root);
+char *acceptInput(struct puzzle *puzzle, char *input);
+char *displayWord(char *masterWordStr);
+struct gameListNode *createGameList(char *word);
+const char *getRandomWord(struct dictionary *dictionary);
+struct gameListNode *findWords(struct dictionary *dictionary, char *masterWord);
+struct puzzle *buildPuzzle();
+struct puzzle *assemblePuzzle(unsigned long id, const char *masterWord, const char *words, size_t stride, int wordCount, const uint64_t *found);
+void releasePuzzle(struct puzzle *puzzle);
+void capitalizedWordInGameList(struct gameListNode *root);
+void addGameListNode(char *word, struct gameListNode *root);
+void cheat(struct puzzle *puzzle);
+void setAllWordsToNotFound(struct gameListNode *root);
+void cleanupDictionary();
+void cleanupGameListNode(struct gameListNode *root);
+void seedRandomWord(unsigned int seed);
+int acceptGuesses(struct puzzle *puzzle, char **guesses, int guessCount, int *results);
+int compareGuess(const void *a, const void *b);
+int buildHintIndex(struct puzzle *puzzle);
+int compareHintWord(const void *a, const void *b);
+int hintRange(struct puzzle *puzzle, int length, const char *prefix, int *first);
+int countHints(struct puzzle *puzzle, int length, const char *prefix, int *hidden);
+struct gameListNode *revealHint(struct puzzle *puzzle, int length, const char *prefix);
+
+//Global variable 
+extern int BUFFER_SIZE;
+//Range of words on the board new puzzles are picked from (see getRandomWord)
+extern int puzzleMinSolutions;
+extern int puzzleMaxSolutions;
+//Id of the last puzzle built, and the state of the master word picker (see seedRandomWord)
+extern unsigned long puzzleCounter;
+extern unsigned int randomWordSeed;
+//Word list file read by initialization. NULL uses the tables compiled into the binary, or
+//2of12.txt in the working directory when the build has none.
+extern const char *dictionaryPath;
+//Optional callback run after a guess, a batch, a hint or the cheat code newly finds words.
+//isGuessed is 1 for words matched by a guess (acceptInput, acceptGuesses) and 0 for words
+//revealed (cheat, revealHint). The server uses it to bump the state version, notify
+//subscribers, score guesses and roll the puzzle over.
+extern void (*wordsFoundHook)(struct puzzle *puzzle, struct gameListNode **words, int count, int isGuessed);
+
+#endif